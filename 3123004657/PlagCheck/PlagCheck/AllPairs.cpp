@@ -0,0 +1,102 @@
+#include "AllPairs.h"
+#include "PlagCheck.h"
+#include "CorpusIngest.h"
+#include "Stats.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    std::vector<DocumentFingerprint> fingerprint_files(const std::vector<std::string>& paths, WorkStealingPool& pool,
+        int ngram, FingerprintCache* cache) {
+        std::vector<DocumentFingerprint> results(paths.size());
+        ingest_corpus(paths, pool, [&results, ngram, cache](IngestedFile& file) {
+            DocumentFingerprint& result = results[file.index];
+            if (!file.error.empty()) {
+                result.error = std::move(file.error);
+                return;
+            }
+            CacheEntry entry = cached_fingerprint(file.content, ngram, cache);
+            result.fingerprint = entry.fingerprint;
+            result.words = entry.words;
+        });
+        return results;
+    }
+
+    CorpusFingerprints fingerprint_corpus(const std::vector<std::string>& paths, WorkStealingPool& pool,
+        int ngram, FingerprintCache* cache, bool strict) {
+        std::vector<DocumentFingerprint> results = fingerprint_files(paths, pool, ngram, cache);
+        CorpusFingerprints corpus;
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            if (!results[i].error.empty()) {
+                if (strict) {
+                    throw std::runtime_error(results[i].error);
+                }
+                std::cerr << results[i].error << std::endl;
+            }
+            if (results[i].words == 0) {
+                ++corpus.skipped;
+                continue;
+            }
+            corpus.paths.push_back(paths[i]);
+            corpus.fingerprints.push_back(results[i].fingerprint);
+        }
+        return corpus;
+    }
+
+    std::vector<SimilarPair> all_pairs(const std::vector<std::bitset<64>>& fingerprints, double threshold,
+        WorkStealingPool& pool, std::size_t tile) {
+        //汉明距离不超过maxDistance的文档对相似度达到阈值
+        int maxDistance = -1;
+        while (maxDistance < 64 && similarity_from_distance(maxDistance + 1) >= threshold) {
+            ++maxDistance;
+        }
+        std::vector<SimilarPair> pairs;
+        if (maxDistance < 0 || fingerprints.size() < 2) {
+            return pairs;
+        }
+        tile = std::max<std::size_t>(tile, 1);
+
+        //转为连续的64位整数，便于分块遍历
+        std::vector<std::uint64_t> packed(fingerprints.size());
+        for (std::size_t i = 0; i < fingerprints.size(); ++i) {
+            packed[i] = fingerprints[i].to_ullong();
+        }
+
+        ScopedTimer timer(Phase::Compare);
+        std::mutex pairsMutex;
+        std::size_t tiles = (packed.size() + tile - 1) / tile;
+        for (std::size_t bi = 0; bi < tiles; ++bi) {
+            for (std::size_t bj = bi; bj < tiles; ++bj) {
+                pool.submit([&, bi, bj] {
+                    std::size_t rowEnd = std::min(packed.size(), (bi + 1) * tile);
+                    std::size_t colEnd = std::min(packed.size(), (bj + 1) * tile);
+                    std::vector<SimilarPair> found;
+                    for (std::size_t i = bi * tile; i < rowEnd; ++i) {
+                        std::uint64_t row = packed[i];
+                        std::size_t j = bi == bj ? i + 1 : bj * tile;
+                        for (; j < colEnd; ++j) {
+                            int distance = std::popcount(row ^ packed[j]);
+                            if (distance <= maxDistance) {
+                                found.push_back({ i, j, distance });
+                            }
+                        }
+                    }
+                    if (!found.empty()) {
+                        std::lock_guard<std::mutex> lock(pairsMutex);
+                        pairs.insert(pairs.end(), found.begin(), found.end());
+                    }
+                });
+            }
+        }
+        pool.wait();
+        std::sort(pairs.begin(), pairs.end(), [](const SimilarPair& a, const SimilarPair& b) {
+            return a.first != b.first ? a.first < b.first : a.second < b.second;
+        });
+        return pairs;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "WorkStealingPool.hpp"
+#include "FingerprintCache.h"
+#include <string>
+#include <vector>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace PlagCheck {
+    /*
+        @brief 一对相似文档
+        @param first 第一篇文档的下标
+        @param second 第二篇文档的下标，总是大于first
+        @param distance 两篇文档SimHash值之间的汉明距离
+    */
+    struct SimilarPair {
+        std::size_t first;
+        std::size_t second;
+        int distance;
+    };
+
+    /*
+        @brief 一个文件的指纹计算结果
+        @param fingerprint SimHash值
+        @param words 文档的单词数，为0时文档没有任何特征，指纹为全0
+        @param error 读取失败时的错误信息，读取成功时为空
+    */
+    struct DocumentFingerprint {
+        std::bitset<64> fingerprint;
+        std::uint64_t words = 0;
+        std::string error;
+    };
+
+    /*
+        @brief 可以参与比较的语料库文档
+        @param paths 文档路径，保持原来的相对顺序
+        @param fingerprints 与paths一一对应的SimHash值
+        @param skipped 因无法读取或没有单词而被排除的文档数
+    */
+    struct CorpusFingerprints {
+        std::vector<std::string> paths;
+        std::vector<std::bitset<64>> fingerprints;
+        std::size_t skipped = 0;
+    };
+
+    /*
+        @brief 并行读取并计算一组文件的SimHash值，每篇文档只分词、哈希一次
+        @details 文件由ingest_corpus读取，读取与分词重叠进行
+        @param paths 文件路径
+        @param pool 执行任务的线程池
+        @param ngram 以几个单词的n-gram为特征，取值[1, 5]
+        @param cache 指纹缓存，内容未变化的文件跳过分词；为nullptr时不使用缓存
+        @return 返回与paths一一对应的结果，无法读取的文件带有错误信息
+    */
+    std::vector<DocumentFingerprint> fingerprint_files(const std::vector<std::string>& paths, WorkStealingPool& pool,
+        int ngram = 1, FingerprintCache* cache = nullptr);
+
+    /*
+        @brief 计算一组文件的SimHash值，并排除无法读取和没有单词的文档
+        @details 空文件和只含标点的文件没有特征，指纹为全0，彼此之间的汉明距离为0。
+                 两文件比较时这类文档的相似度为0，所以它们不参与语料库的比较、检索与聚类，
+                 否则会被互相报告为完全相同。
+        @param paths 文件路径
+        @param pool 执行任务的线程池
+        @param ngram 以几个单词的n-gram为特征，取值[1, 5]
+        @param cache 指纹缓存，为nullptr时不使用缓存
+        @param strict 为true时遇到无法读取的文件抛出异常；为false时把错误输出到std::cerr后跳过该文件
+        @return 返回保留的文档及其指纹
+        @throws runtime_error 如果strict为true且有文件无法读取，报告路径顺序中的第一个
+    */
+    CorpusFingerprints fingerprint_corpus(const std::vector<std::string>& paths, WorkStealingPool& pool,
+        int ngram = 1, FingerprintCache* cache = nullptr, bool strict = false);
+
+    /*
+        @brief 并行计算全部文档两两之间的相似度，只返回达到阈值的文档对
+        @details 相似度矩阵的上三角按tile×tile的分块切分，每个分块的两段指纹共占 2×tile×8 字节，
+                 可以常驻L1/L2缓存；分块作为任务提交给工作窃取线程池，由空闲线程自动均衡。
+        @param fingerprints 文档的SimHash值
+        @param threshold 相似度阈值，取值[0, 1]
+        @param pool 执行任务的线程池
+        @param tile 分块边长（文档数）
+        @return 返回按(first, second)排序的相似文档对
+    */
+    std::vector<SimilarPair> all_pairs(const std::vector<std::bitset<64>>& fingerprints, double threshold,
+        WorkStealingPool& pool, std::size_t tile = 1024);
+}
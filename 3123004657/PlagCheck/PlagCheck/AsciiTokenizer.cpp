@@ -0,0 +1,318 @@
+#include "AsciiTokenizer.h"
+#include "SimHashKernel.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PLAGCHECK_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(PLAGCHECK_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PLAGCHECK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PLAGCHECK_TARGET_AVX2
+#endif
+
+namespace PlagCheck {
+
+    //字节类别，与ICU单词边界属性的对应：Letter为ALetter，Digit为Numeric，Underscore为ExtendNumLet
+    enum ByteClass : std::uint8_t {
+        Letter = 1,
+        Digit = 2,
+        Underscore = 4,
+        MidLetter = 8,
+        MidNum = 16,
+        Control = 32
+    };
+
+    static std::array<std::uint8_t, 128> make_class_table() {
+        std::array<std::uint8_t, 128> table{};
+        for (int c = 0; c < 128; ++c) {
+            std::uint8_t flags = 0;
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '@') {
+                flags |= Letter;
+            }
+            if (c >= '0' && c <= '9') {
+                flags |= Digit;
+            }
+            if (c == '_') {
+                flags |= Underscore;
+            }
+            if (c == '.' || c == '\'') {
+                flags |= MidLetter | MidNum;
+            }
+            if (c == ',' || c == ';') {
+                flags |= MidNum;
+            }
+            //\t\n\v\f\r是空白，其余控制字符在ICU中各自成词，且不会被标点过滤
+            if ((c < 0x20 && (c < 0x09 || c > 0x0D)) || c == 0x7F) {
+                flags |= Control;
+            }
+            table[c] = flags;
+        }
+        return table;
+    }
+
+    static const std::array<std::uint8_t, 128> classTable = make_class_table();
+
+    /*
+        @brief 一个块（最多64字节）中各类字节的位掩码，第i位对应块内第i个字节
+    */
+    struct ClassMasks {
+        std::uint64_t letter = 0;
+        std::uint64_t digit = 0;
+        std::uint64_t underscore = 0;
+        std::uint64_t midLetter = 0;
+        std::uint64_t midNum = 0;
+        std::uint64_t control = 0;
+    };
+
+    static void classify_scalar(const char* data, std::size_t size, ClassMasks& masks) {
+        masks = ClassMasks();
+        for (std::size_t i = 0; i < size; ++i) {
+            std::uint8_t flags = classTable[static_cast<unsigned char>(data[i]) & 0x7F];
+            std::uint64_t bit = std::uint64_t(1) << i;
+            masks.letter |= (flags & Letter) ? bit : 0;
+            masks.digit |= (flags & Digit) ? bit : 0;
+            masks.underscore |= (flags & Underscore) ? bit : 0;
+            masks.midLetter |= (flags & MidLetter) ? bit : 0;
+            masks.midNum |= (flags & MidNum) ? bit : 0;
+            masks.control |= (flags & Control) ? bit : 0;
+        }
+    }
+
+    static void classify_block_scalar(const char* data, ClassMasks& masks) {
+        classify_scalar(data, 64, masks);
+    }
+
+    static std::size_t find_non_ascii_scalar(const char* data, std::size_t size) {
+        std::size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            if (word & 0x8080808080808080ull) {
+                break;
+            }
+        }
+        for (; i < size; ++i) {
+            if (static_cast<unsigned char>(data[i]) >= 0x80) {
+                return i;
+            }
+        }
+        return size;
+    }
+
+#if defined(PLAGCHECK_X86)
+    PLAGCHECK_TARGET_AVX2
+    static inline std::uint64_t movemask64(__m256i mask, int shift) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(mask))) << shift;
+    }
+
+    /*
+        @brief AVX2内核：32字节一组做范围比较与相等比较，movemask得到各类字节的位掩码
+        @details 输入只含ASCII，字节按有符号数比较不会越界
+    */
+    PLAGCHECK_TARGET_AVX2
+    static void classify_block_avx2(const char* data, ClassMasks& masks) {
+        const __m256i caseBit = _mm256_set1_epi8(0x20);
+        const __m256i beforeA = _mm256_set1_epi8('a' - 1);
+        const __m256i afterZ = _mm256_set1_epi8('z' + 1);
+        const __m256i before0 = _mm256_set1_epi8('0' - 1);
+        const __m256i after9 = _mm256_set1_epi8('9' + 1);
+        const __m256i at = _mm256_set1_epi8('@');
+        const __m256i underscore = _mm256_set1_epi8('_');
+        const __m256i dot = _mm256_set1_epi8('.');
+        const __m256i apostrophe = _mm256_set1_epi8('\'');
+        const __m256i comma = _mm256_set1_epi8(',');
+        const __m256i semicolon = _mm256_set1_epi8(';');
+        const __m256i space = _mm256_set1_epi8(0x20);
+        const __m256i beforeTab = _mm256_set1_epi8(0x08);
+        const __m256i afterCr = _mm256_set1_epi8(0x0E);
+        const __m256i del = _mm256_set1_epi8(0x7F);
+        masks = ClassMasks();
+        for (int half = 0; half < 2; ++half) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32 * half));
+            __m256i lower = _mm256_or_si256(v, caseBit);
+            __m256i letter = _mm256_or_si256(
+                _mm256_and_si256(_mm256_cmpgt_epi8(lower, beforeA), _mm256_cmpgt_epi8(afterZ, lower)),
+                _mm256_cmpeq_epi8(v, at));
+            __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, before0), _mm256_cmpgt_epi8(after9, v));
+            __m256i midLetter = _mm256_or_si256(_mm256_cmpeq_epi8(v, dot), _mm256_cmpeq_epi8(v, apostrophe));
+            __m256i midNum = _mm256_or_si256(midLetter,
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, comma), _mm256_cmpeq_epi8(v, semicolon)));
+            __m256i whitespace = _mm256_and_si256(_mm256_cmpgt_epi8(v, beforeTab), _mm256_cmpgt_epi8(afterCr, v));
+            __m256i control = _mm256_or_si256(
+                _mm256_andnot_si256(whitespace, _mm256_cmpgt_epi8(space, v)),
+                _mm256_cmpeq_epi8(v, del));
+            int shift = 32 * half;
+            masks.letter |= movemask64(letter, shift);
+            masks.digit |= movemask64(digit, shift);
+            masks.underscore |= movemask64(_mm256_cmpeq_epi8(v, underscore), shift);
+            masks.midLetter |= movemask64(midLetter, shift);
+            masks.midNum |= movemask64(midNum, shift);
+            masks.control |= movemask64(control, shift);
+        }
+    }
+
+    PLAGCHECK_TARGET_AVX2
+    static std::size_t find_non_ascii_avx2(const char* data, std::size_t size) {
+        std::size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            std::uint32_t high = static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+            if (high != 0) {
+#if defined(_MSC_VER) && !defined(__clang__)
+                unsigned long index;
+                _BitScanForward(&index, high);
+                return i + index;
+#else
+                return i + static_cast<std::size_t>(__builtin_ctz(high));
+#endif
+            }
+        }
+        return i + find_non_ascii_scalar(data + i, size - i);
+    }
+#endif
+
+    using ClassifyKernel = void (*)(const char*, ClassMasks&);
+    using FindKernel = std::size_t(*)(const char*, std::size_t);
+
+    static ClassifyKernel selected_classify() {
+#if defined(PLAGCHECK_X86)
+        static const ClassifyKernel kernel = cpu_has_avx2() ? classify_block_avx2 : classify_block_scalar;
+#else
+        static const ClassifyKernel kernel = classify_block_scalar;
+#endif
+        return kernel;
+    }
+
+    static FindKernel selected_find() {
+#if defined(PLAGCHECK_X86)
+        static const FindKernel kernel = cpu_has_avx2() ? find_non_ascii_avx2 : find_non_ascii_scalar;
+#else
+        static const FindKernel kernel = find_non_ascii_scalar;
+#endif
+        return kernel;
+    }
+
+    static int lowest_bit(std::uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+
+    /*
+        @brief 输出一个单词，只由标点组成的片段与Tokenizer一样跳过
+    */
+    static void emit_word(std::string_view text, std::size_t begin, std::size_t end, std::vector<std::string_view>& words) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (std::isalnum(static_cast<unsigned char>(text[i]))) {
+                words.push_back(text.substr(begin, end - begin));
+                return;
+            }
+        }
+    }
+
+    std::size_t find_non_ascii(std::string_view text, std::size_t pos) {
+        if (pos >= text.size()) {
+            return text.size();
+        }
+        return pos + selected_find()(text.data() + pos, text.size() - pos);
+    }
+
+    /*
+        @brief tokenize_ascii的实现，64字节的整块由classify分类
+    */
+    static void tokenize_with(ClassifyKernel classify, std::string_view text, std::vector<std::string_view>& words) {
+        const std::size_t size = text.size();
+        //上一块最后一个字节的状态：是否在单词内、是否为字母、是否为数字
+        std::uint64_t carryToken = 0;
+        std::uint64_t carryLetter = 0;
+        std::uint64_t carryDigit = 0;
+        std::size_t wordBegin = 0;
+        for (std::size_t base = 0; base < size; base += 64) {
+            std::size_t length = std::min<std::size_t>(64, size - base);
+            ClassMasks masks;
+            if (length == 64) {
+                classify(text.data() + base, masks);
+            }
+            else {
+                classify_scalar(text.data() + base, length, masks);
+            }
+            //连接符需要看下一块的第一个字节
+            std::uint64_t nextLetter = 0;
+            std::uint64_t nextDigit = 0;
+            if (base + 64 < size) {
+                std::uint8_t flags = classTable[static_cast<unsigned char>(text[base + 64]) & 0x7F];
+                nextLetter = (flags & Letter) ? 1 : 0;
+                nextDigit = (flags & Digit) ? 1 : 0;
+            }
+            std::uint64_t letterBefore = (masks.letter << 1) | carryLetter;
+            std::uint64_t letterAfter = (masks.letter >> 1) | (nextLetter << 63);
+            std::uint64_t digitBefore = (masks.digit << 1) | carryDigit;
+            std::uint64_t digitAfter = (masks.digit >> 1) | (nextDigit << 63);
+            std::uint64_t joiner = (masks.midLetter & letterBefore & letterAfter) |
+                (masks.midNum & digitBefore & digitAfter);
+            std::uint64_t token = masks.letter | masks.digit | masks.underscore | joiner;
+            std::uint64_t previous = (token << 1) | carryToken;
+            std::uint64_t starts = token & ~previous;
+            std::uint64_t ends = ~token & previous;
+            //块不足64字节时，length之后的位都为0，单词在文本末尾的结束也会出现在ends中
+            if (length < 64) {
+                ends &= (std::uint64_t(2) << length) - 1;
+            }
+            std::uint64_t events = starts | ends | masks.control;
+            while (events != 0) {
+                int i = lowest_bit(events);
+                std::uint64_t bit = std::uint64_t(1) << i;
+                if (ends & bit) {
+                    emit_word(text, wordBegin, base + i, words);
+                }
+                if (masks.control & bit) {
+                    words.push_back(text.substr(base + i, 1));
+                }
+                if (starts & bit) {
+                    wordBegin = base + i;
+                }
+                events &= events - 1;
+            }
+            carryToken = token >> 63;
+            carryLetter = masks.letter >> 63;
+            carryDigit = masks.digit >> 63;
+        }
+        if (carryToken != 0) {
+            emit_word(text, wordBegin, size, words);
+        }
+    }
+
+    void tokenize_ascii(std::string_view text, std::vector<std::string_view>& words) {
+        tokenize_with(selected_classify(), text, words);
+    }
+
+    void tokenize_ascii_scalar(std::string_view text, std::vector<std::string_view>& words) {
+        tokenize_with(classify_block_scalar, text, words);
+    }
+
+    void tokenize_ascii_avx2(std::string_view text, std::vector<std::string_view>& words) {
+#if defined(PLAGCHECK_X86)
+        tokenize_with(classify_block_avx2, text, words);
+#else
+        tokenize_with(classify_block_scalar, text, words);
+#endif
+    }
+
+    const char* ascii_kernel_name() {
+        return selected_classify() == classify_block_scalar ? "scalar" : "avx2";
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 查找第一个非ASCII字节
+        @details 支持AVX2时每次检查32字节的最高位，否则每次检查8字节
+        @param text 输入的文本
+        @param pos 开始查找的位置
+        @return 返回不小于pos的第一个非ASCII字节的位置，没有时返回text.size()
+    */
+    std::size_t find_non_ascii(std::string_view text, std::size_t pos = 0);
+
+    /*
+        @brief 对纯ASCII文本分词，结果与ICU单词边界规则加标点过滤完全相同
+        @details 按64字节分块，用向量比较把每个字节分类为字母（含@）、数字、下划线、
+                 连接符（. ' 连接两侧字母，. ' , ; 连接两侧数字）与控制字符，
+                 得到64位掩码后用位运算求出单词的起止位置：
+                 字母、数字、下划线连续出现时属于同一单词，两侧同为字母或同为数字的连接符并入单词，
+                 每个控制字符单独成词，其余的空白和标点不输出。
+                 只由标点组成的片段（如单独的 _ 或 @）与Tokenizer一样被过滤。
+        @param text 输入的文本，必须只含ASCII字符，且在words使用期间有效
+        @param words 单词追加到其末尾
+    */
+    void tokenize_ascii(std::string_view text, std::vector<std::string_view>& words);
+
+    /*
+        @brief 用标量分类内核的tokenize_ascii，结果与tokenize_ascii相同
+        @param text 输入的文本，必须只含ASCII字符，且在words使用期间有效
+        @param words 单词追加到其末尾
+    */
+    void tokenize_ascii_scalar(std::string_view text, std::vector<std::string_view>& words);
+
+    /*
+        @brief 用AVX2分类内核的tokenize_ascii，调用前需确认cpu_has_avx2()，非x86平台上等同于标量版本
+        @param text 输入的文本，必须只含ASCII字符，且在words使用期间有效
+        @param words 单词追加到其末尾
+    */
+    void tokenize_ascii_avx2(std::string_view text, std::vector<std::string_view>& words);
+
+    /*
+        @brief 获取当前选用的ASCII分类内核名称
+        @return 返回 "avx2" 或 "scalar"
+    */
+    const char* ascii_kernel_name();
+}
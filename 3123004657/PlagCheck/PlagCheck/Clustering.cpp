@@ -0,0 +1,104 @@
+#include "Clustering.h"
+#include "SimHashIndex.h"
+#include "Stats.h"
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <utility>
+
+namespace PlagCheck {
+
+    DisjointSet::DisjointSet(std::size_t count)
+        : parent(count), setSize(count, 1) {
+        std::iota(parent.begin(), parent.end(), std::size_t{ 0 });
+    }
+
+    std::size_t DisjointSet::find(std::size_t x) {
+        //路径减半：每一步把节点挂到祖父节点上
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    bool DisjointSet::unite(std::size_t a, std::size_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+            return false;
+        }
+        if (setSize[a] < setSize[b]) {
+            std::swap(a, b);
+        }
+        parent[b] = a;
+        setSize[a] += setSize[b];
+        return true;
+    }
+
+    std::vector<std::vector<std::size_t>> cluster_near_duplicates(const std::vector<std::bitset<64>>& fingerprints,
+        int maxDistance, WorkStealingPool& pool) {
+        SimHashIndex index(maxDistance);
+        DisjointSet sets(fingerprints.size());
+
+        //相同指纹的文档直接合并，一份作业被多人提交时，桶内只剩一个代表，避免候选对按平方增长
+        std::vector<std::pair<std::uint64_t, std::size_t>> sorted(fingerprints.size());
+        for (std::size_t i = 0; i < fingerprints.size(); ++i) {
+            sorted[i] = { fingerprints[i].to_ullong(), i };
+        }
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<std::size_t> representatives;
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            if (i > 0 && sorted[i].first == sorted[i - 1].first) {
+                sets.unite(representatives.back(), sorted[i].second);
+                continue;
+            }
+            representatives.push_back(sorted[i].second);
+            index.add(std::string(), fingerprints[sorted[i].second]);
+        }
+        index.build();
+
+        //每个代表查询一次索引，只保留下标更大的一侧，每对候选只记录一次
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        std::mutex edgesMutex;
+        const std::size_t chunk = 4096;
+        for (std::size_t begin = 0; begin < representatives.size(); begin += chunk) {
+            pool.submit([&, begin] {
+                std::size_t end = std::min(representatives.size(), begin + chunk);
+                std::vector<std::pair<std::size_t, std::size_t>> found;
+                for (std::size_t r = begin; r < end; ++r) {
+                    for (const auto& match : index.query(index.fingerprint(r), maxDistance)) {
+                        if (match.doc > r) {
+                            found.emplace_back(representatives[r], representatives[match.doc]);
+                        }
+                    }
+                }
+                if (!found.empty()) {
+                    std::lock_guard<std::mutex> lock(edgesMutex);
+                    edges.insert(edges.end(), found.begin(), found.end());
+                }
+            });
+        }
+        pool.wait();
+
+        ScopedTimer timer(Phase::Compare);
+        for (const auto& edge : edges) {
+            sets.unite(edge.first, edge.second);
+        }
+        std::vector<std::vector<std::size_t>> members(fingerprints.size());
+        for (std::size_t i = 0; i < fingerprints.size(); ++i) {
+            members[sets.find(i)].push_back(i);
+        }
+        std::vector<std::vector<std::size_t>> clusters;
+        for (auto& cluster : members) {
+            if (cluster.size() > 1) {
+                clusters.push_back(std::move(cluster));
+            }
+        }
+        std::sort(clusters.begin(), clusters.end(), [](const auto& a, const auto& b) {
+            return a.size() != b.size() ? a.size() > b.size() : a.front() < b.front();
+        });
+        return clusters;
+    }
+}
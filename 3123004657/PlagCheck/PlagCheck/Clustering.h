@@ -0,0 +1,55 @@
+#pragma once
+#include "WorkStealingPool.hpp"
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 并查集，按集合大小合并并在查找时压缩路径
+        @method find 查找元素所在集合的代表元
+        @method unite 合并两个元素所在的集合
+    */
+    class DisjointSet {
+    public:
+        /*
+            @brief 构造函数，每个元素各自成为一个集合
+            @param count 元素个数
+        */
+        explicit DisjointSet(std::size_t count);
+
+        /*
+            @brief 查找元素所在集合的代表元
+            @param x 元素下标
+            @return 返回代表元下标
+        */
+        std::size_t find(std::size_t x);
+
+        /*
+            @brief 合并两个元素所在的集合
+            @return 两个元素原本不在同一集合时返回true
+        */
+        bool unite(std::size_t a, std::size_t b);
+
+    private:
+        std::vector<std::size_t> parent;
+        std::vector<std::size_t> setSize;
+    };
+
+    /*
+        @brief 把文档聚成近似重复的家族：汉明距离不超过maxDistance的文档对连边，连通分量即为一个家族
+        @details 指纹完全相同的文档先合并，只保留一个代表；代表的指纹放入 max_distance 为maxDistance的
+                 SimHashIndex，由置换分块表按块值分桶给出候选对，精确校验距离后用并查集合并，
+                 不需要比较全部文档对，文档数为n时耗时近似 O(n log n)。查询按文档分段并行执行。
+                 家族关系是传递的：A与B、B与C相近时A、B、C同属一个家族，即使A与C的距离超过阈值。
+        @param fingerprints 文档的SimHash值，应先排除没有单词的文档（见fingerprint_corpus），它们的全0指纹彼此完全相同
+        @param maxDistance 汉明距离阈值，取值[0, 63]，越大分块越短、候选越多，通常取3
+        @param pool 执行查询的线程池
+        @return 返回包含至少两篇文档的家族，每个家族内的文档下标升序，
+                家族按文档数降序排列，文档数相同时按首个文档下标升序
+        @throws invalid_argument 如果maxDistance不在[0, 63]之间
+    */
+    std::vector<std::vector<std::size_t>> cluster_near_duplicates(const std::vector<std::bitset<64>>& fingerprints,
+        int maxDistance, WorkStealingPool& pool);
+}
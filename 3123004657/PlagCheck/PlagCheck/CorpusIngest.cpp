@@ -0,0 +1,131 @@
+#include "CorpusIngest.h"
+#include "Stats.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace PlagCheck {
+
+    std::vector<std::string> list_corpus_files(const std::string& dir) {
+        std::vector<std::string> files;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    /*
+        @brief 把读完的文件放入队列
+        @return 队列已关闭（处理端出错）时返回false
+    */
+    static bool deliver(BoundedQueue<IngestedFile>& queue, std::size_t index, std::string content, std::string error = {}) {
+        if (Stats::enabled()) {
+            Stats::add_bytes(content.size());
+        }
+        return queue.push(IngestedFile{ index, std::move(content), std::move(error) });
+    }
+
+    /*
+        @brief 同步读取整个文件
+        @throws runtime_error 如果文件无法打开
+    */
+    static std::string read_whole_file(const std::string& path) {
+        ScopedTimer timer(Phase::Read);
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + path);
+        }
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(path, error);
+        std::string content(error ? 0 : static_cast<std::size_t>(size), '\0');
+        file.read(content.data(), static_cast<std::streamsize>(content.size()));
+        content.resize(static_cast<std::size_t>(file.gcount()));
+        return content;
+    }
+
+    /*
+        @brief 多个读取线程按下标依次领取文件并同步读取，读取失败的文件带着错误信息交给处理端
+    */
+    static void read_with_threads(const std::vector<std::string>& paths, BoundedQueue<IngestedFile>& queue,
+        std::size_t readers) {
+        readers = std::clamp<std::size_t>(readers, 1, paths.size());
+        std::atomic<std::size_t> next{ 0 };
+        std::vector<std::thread> threads;
+        threads.reserve(readers);
+        for (std::size_t r = 0; r < readers; ++r) {
+            threads.emplace_back([&paths, &queue, &next] {
+                for (std::size_t i = next.fetch_add(1); i < paths.size(); i = next.fetch_add(1)) {
+                    std::string content;
+                    std::string error;
+                    try {
+                        content = read_whole_file(paths[i]);
+                    }
+                    catch (const std::exception& e) {
+                        error = e.what();
+                    }
+                    if (!deliver(queue, i, std::move(content), std::move(error))) {
+                        break;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void ingest_corpus(const std::vector<std::string>& paths, WorkStealingPool& pool,
+        const std::function<void(IngestedFile&)>& consume, const IngestOptions& options) {
+        if (paths.empty()) {
+            return;
+        }
+        std::size_t consumers = pool.size();
+        BoundedQueue<IngestedFile> queue(options.queueCapacity == 0 ? 2 * consumers : options.queueCapacity);
+        std::mutex failureMutex;
+        std::exception_ptr failure;
+        for (std::size_t c = 0; c < consumers; ++c) {
+            pool.submit([&queue, &consume, &failureMutex, &failure] {
+                IngestedFile file;
+                while (queue.pop(file)) {
+                    try {
+                        consume(file);
+                    }
+                    catch (...) {
+                        //关闭队列使读取线程停止，其余工作线程取完已读入的文件后退出
+                        {
+                            std::lock_guard<std::mutex> lock(failureMutex);
+                            if (!failure) {
+                                failure = std::current_exception();
+                            }
+                        }
+                        queue.close();
+                        return;
+                    }
+                }
+            });
+        }
+        //读取端在调用线程上运行，读取结束后关闭队列，工作线程处理完剩余的文件后退出
+        try {
+            read_with_threads(paths, queue, options.readers);
+        }
+        catch (...) {
+            queue.close();
+            pool.wait();
+            throw;
+        }
+        queue.close();
+        pool.wait();
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include "WorkStealingPool.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 有界阻塞队列
+        @details 队列满时push阻塞，空时pop阻塞，用于在读取线程与分词线程之间传递文件内容，
+                 读取快于分词时限制驻留内存的文件数。close之后push失败，pop取完剩余元素后返回false。
+        @method push 放入一个元素
+        @method pop 取出一个元素
+        @method close 关闭队列，唤醒所有等待的线程
+    */
+    template<typename T>
+    class BoundedQueue {
+    public:
+        /*
+            @brief 构造函数
+            @param capacity 队列容量，至少为1
+        */
+        explicit BoundedQueue(std::size_t capacity)
+            : capacity(capacity == 0 ? 1 : capacity) {}
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        /*
+            @brief 放入一个元素，队列满时阻塞
+            @param item 要放入的元素
+            @return 队列已关闭时返回false，元素被丢弃
+        */
+        bool push(T item) {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+            if (closed) {
+                return false;
+            }
+            items.push_back(std::move(item));
+            lock.unlock();
+            notEmpty.notify_one();
+            return true;
+        }
+
+        /*
+            @brief 取出一个元素，队列空时阻塞
+            @param item 取出的元素
+            @return 队列已关闭且为空时返回false
+        */
+        bool pop(T& item) {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+            if (items.empty()) {
+                return false;
+            }
+            item = std::move(items.front());
+            items.pop_front();
+            lock.unlock();
+            notFull.notify_one();
+            return true;
+        }
+
+        /*
+            @brief 关闭队列，已放入的元素仍可以取出
+        */
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+            }
+            notFull.notify_all();
+            notEmpty.notify_all();
+        }
+
+    private:
+        std::size_t capacity;
+        std::deque<T> items;
+        std::mutex mutex;
+        std::condition_variable notFull;
+        std::condition_variable notEmpty;
+        bool closed = false;
+    };
+
+    /*
+        @brief 一个读取完成的语料文件
+        @param index 文件在路径列表中的下标
+        @param content 文件的全部内容
+        @param error 读取失败时的错误信息，此时content为空；读取成功时为空
+    */
+    struct IngestedFile {
+        std::size_t index = 0;
+        std::string content;
+        std::string error;
+    };
+
+    /*
+        @brief 语料读取的参数
+        @param readers 读取线程数，即同时进行的读取数
+        @param queueCapacity 读取完成、等待分词的文件数上限，为0时取分词线程数的2倍
+    */
+    struct IngestOptions {
+        std::size_t readers = 8;
+        std::size_t queueCapacity = 0;
+    };
+
+    /*
+        @brief 递归列出语料库目录下的全部普通文件
+        @param dir 语料库目录
+        @return 返回按路径排序的文件路径
+    */
+    std::vector<std::string> list_corpus_files(const std::string& dir);
+
+    /*
+        @brief 读取一组文件并交给线程池处理，读取与处理重叠进行
+        @details readers个读取线程各自同步读取整个文件，使多个读取同时进行；读完的文件经有界队列交给线程池，
+                 每个工作线程循环取出文件并调用consume，队列满时读取线程暂停，驻留内存的文件数有上限。
+                 consume在多个线程上并发调用，文件完成的顺序与paths的顺序无关。
+                 无法读取的文件同样交给consume，由IngestedFile::error说明原因，是否跳过由调用者决定。
+                 consume抛出异常说明处理本身出错（如参数无效），而不是某个文件的问题：
+                 此时停止读取，等待所有工作线程退出后把第一个异常重新抛给调用者。
+        @param paths 文件路径
+        @param pool 执行consume的线程池，调用期间被占满，不能在其工作线程内调用
+        @param consume 处理一个文件，必须是线程安全的
+        @param options 读取参数
+        @throws 重新抛出consume抛出的第一个异常
+    */
+    void ingest_corpus(const std::vector<std::string>& paths, WorkStealingPool& pool,
+        const std::function<void(IngestedFile&)>& consume, const IngestOptions& options = {});
+}
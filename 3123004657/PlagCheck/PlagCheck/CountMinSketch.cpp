@@ -0,0 +1,124 @@
+#include "CountMinSketch.h"
+#include "PlagCheck.h"
+#include "Hashing.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    static const char sketchMagic[4] = { 'P', 'C', 'C', 'M' };
+    //版本2起行哈希基于xxHash64的string_hash，与平台无关
+    static const std::uint32_t sketchVersion = 2;
+
+    CountMinSketch::CountMinSketch(std::uint32_t width, std::uint32_t depth)
+        : width(width), depth(depth) {
+        if (width == 0 || depth == 0) {
+            throw std::invalid_argument("CountMinSketch width and depth must be positive.");
+        }
+        counters.assign(static_cast<std::size_t>(width) * depth, 0);
+    }
+
+    std::size_t CountMinSketch::cell(std::uint64_t hash, std::uint32_t row) const {
+        //双重哈希：第row行使用 h1 + row * h2
+        std::uint64_t h1 = mix64(hash);
+        std::uint64_t h2 = mix64(hash ^ 0x5851F42D4C957F2DULL) | 1;
+        return static_cast<std::size_t>(row) * width + static_cast<std::size_t>((h1 + row * h2) % width);
+    }
+
+    void CountMinSketch::add_document(const std::vector<std::string_view>& words) {
+        std::vector<std::uint64_t> hashes;
+        hashes.reserve(words.size());
+        for (const auto& word : words) {
+            hashes.push_back(string_hash(word));
+        }
+        std::sort(hashes.begin(), hashes.end());
+        hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+        for (std::uint64_t hash : hashes) {
+            add_hash(hash);
+        }
+        ++documentCount;
+    }
+
+    void CountMinSketch::add_hash(std::uint64_t hash, std::uint32_t count) {
+        const std::uint32_t limit = std::numeric_limits<std::uint32_t>::max();
+        for (std::uint32_t row = 0; row < depth; ++row) {
+            std::uint32_t& counter = counters[cell(hash, row)];
+            counter = counter > limit - count ? limit : counter + count;
+        }
+    }
+
+    std::uint32_t CountMinSketch::estimate(std::string_view word) const {
+        return estimate_hash(string_hash(word));
+    }
+
+    std::uint32_t CountMinSketch::estimate_hash(std::uint64_t hash) const {
+        std::uint32_t result = std::numeric_limits<std::uint32_t>::max();
+        for (std::uint32_t row = 0; row < depth; ++row) {
+            result = std::min(result, counters[cell(hash, row)]);
+        }
+        return result;
+    }
+
+    std::uint64_t CountMinSketch::documents() const {
+        return documentCount;
+    }
+
+    void CountMinSketch::save(const std::string& path) const {
+        std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open sketch file for writing: " + path);
+        }
+        out.write(sketchMagic, sizeof(sketchMagic));
+        out.write(reinterpret_cast<const char*>(&sketchVersion), sizeof(sketchVersion));
+        out.write(reinterpret_cast<const char*>(&width), sizeof(width));
+        out.write(reinterpret_cast<const char*>(&depth), sizeof(depth));
+        out.write(reinterpret_cast<const char*>(&documentCount), sizeof(documentCount));
+        out.write(reinterpret_cast<const char*>(counters.data()),
+            static_cast<std::streamsize>(counters.size() * sizeof(std::uint32_t)));
+        if (!out) {
+            throw std::runtime_error("Failed to write sketch file: " + path);
+        }
+    }
+
+    CountMinSketch CountMinSketch::load(const std::string& path) {
+        std::ifstream in(path, std::ios_base::binary);
+        if (!in.is_open()) {
+            throw std::runtime_error("Failed to open sketch file: " + path);
+        }
+        char magic[4];
+        std::uint32_t version = 0;
+        std::uint32_t width = 0;
+        std::uint32_t depth = 0;
+        std::uint64_t documents = 0;
+        in.read(magic, sizeof(magic));
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        in.read(reinterpret_cast<char*>(&width), sizeof(width));
+        in.read(reinterpret_cast<char*>(&depth), sizeof(depth));
+        in.read(reinterpret_cast<char*>(&documents), sizeof(documents));
+        if (!in || std::memcmp(magic, sketchMagic, sizeof(magic)) != 0 || version != sketchVersion ||
+            width == 0 || depth == 0) {
+            throw std::runtime_error("Invalid sketch file: " + path);
+        }
+        //先确认文件中恰好有width * depth个计数器，再按文件头分配内存，损坏的文件头不会导致巨大的分配
+        std::streampos countersBegin = in.tellg();
+        in.seekg(0, std::ios_base::end);
+        std::streampos fileEnd = in.tellg();
+        in.seekg(countersBegin);
+        std::uint64_t expected = static_cast<std::uint64_t>(width) * depth * sizeof(std::uint32_t);
+        if (!in || countersBegin < 0 || fileEnd < countersBegin ||
+            static_cast<std::uint64_t>(fileEnd - countersBegin) != expected) {
+            throw std::runtime_error("Invalid sketch file: " + path);
+        }
+        CountMinSketch sketch(width, depth);
+        sketch.documentCount = documents;
+        in.read(reinterpret_cast<char*>(sketch.counters.data()),
+            static_cast<std::streamsize>(sketch.counters.size() * sizeof(std::uint32_t)));
+        if (!in) {
+            throw std::runtime_error("Truncated sketch file: " + path);
+        }
+        return sketch;
+    }
+}
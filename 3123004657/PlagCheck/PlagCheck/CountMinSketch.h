@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 文档频率Count-Min Sketch
+        @details 用 depth 行 × width 列的计数器近似记录每个词出现在多少篇文档中，
+                 内存只与 width × depth 有关，与词表大小无关；估计值只会偏大不会偏小。
+                 可以保存到磁盘并在之后的运行中重新加载。
+        @method add_document 记录一篇文档中出现过的词
+        @method estimate 估计某个词的文档频率
+        @method save 保存到文件
+        @method load 从文件加载
+    */
+    class CountMinSketch {
+    public:
+        /*
+            @brief 构造函数
+            @param width 每行计数器个数
+            @param depth 行数（独立哈希函数个数）
+            @throws invalid_argument 如果width或depth为0
+        */
+        explicit CountMinSketch(std::uint32_t width = 1u << 20, std::uint32_t depth = 4);
+
+        /*
+            @brief 记录一篇文档，文档中的每个不同的词只计一次
+            @param words 文档的单词序列
+        */
+        void add_document(const std::vector<std::string_view>& words);
+
+        /*
+            @brief 按词的哈希值增加计数
+            @param hash 词的哈希值（string_hash）
+            @param count 增加的次数
+        */
+        void add_hash(std::uint64_t hash, std::uint32_t count = 1);
+
+        /*
+            @brief 估计词的文档频率
+            @param word 词
+            @return 返回包含该词的文档数的估计值
+        */
+        std::uint32_t estimate(std::string_view word) const;
+
+        /*
+            @brief 按词的哈希值估计文档频率
+            @param hash 词的哈希值（string_hash）
+            @return 返回包含该词的文档数的估计值
+        */
+        std::uint32_t estimate_hash(std::uint64_t hash) const;
+
+        /*
+            @brief 获取已记录的文档数
+        */
+        std::uint64_t documents() const;
+
+        /*
+            @brief 保存到文件
+            @param path 文件路径
+            @throws runtime_error 如果文件无法写入
+        */
+        void save(const std::string& path) const;
+
+        /*
+            @brief 从文件加载
+            @param path 文件路径
+            @return 返回加载的Sketch
+            @throws runtime_error 如果文件无法读取或格式不正确
+        */
+        static CountMinSketch load(const std::string& path);
+
+    private:
+        std::uint32_t width;
+        std::uint32_t depth;
+        std::uint64_t documentCount = 0;
+        std::vector<std::uint32_t> counters;
+
+        std::size_t cell(std::uint64_t hash, std::uint32_t row) const;
+    };
+}
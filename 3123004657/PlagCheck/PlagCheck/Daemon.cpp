@@ -0,0 +1,276 @@
+#include "Daemon.h"
+#include "PlagCheck.h"
+#include "Tokenizer.h"
+#include "FingerprintStore.h"
+#include "WorkStealingPool.hpp"
+#include "AllPairs.h"
+#include "CorpusIngest.h"
+#include <algorithm>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    /*
+        @brief 把相似度格式化为两位小数
+    */
+    static std::string format_similarity(double similarity) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2) << similarity;
+        return oss.str();
+    }
+
+    /*
+        @brief 取出命令行中的命令名
+    */
+    static std::string command_name(const std::string& command) {
+        return command.substr(0, command.find(' '));
+    }
+
+    Daemon::Daemon(const DaemonOptions& options)
+        : options(options) {
+        //提前构造原型BreakIterator，第一个请求不再付出ICU初始化开销
+        segmenter = Tokenizer::local().segmenter_id();
+        //每个compare、query请求的文本都会写入缓存，常驻进程必须限制其大小
+        cache = std::make_unique<FingerprintCache>(options.cachePath, options.maxCacheEntries);
+        if (!options.storePath.empty()) {
+            load_store_shard();
+            return;
+        }
+        if (options.corpusDir.empty()) {
+            return;
+        }
+        index = std::make_unique<SimHashIndex>(options.maxDistance);
+        //空文件和只含标点的文档不进入索引，无法读取的文件使守护进程启动失败
+        CorpusFingerprints corpus;
+        {
+            WorkStealingPool pool(options.threads);
+            corpus = fingerprint_corpus(list_corpus_files(options.corpusDir), pool, options.ngram, cache.get(), true);
+        }
+        for (std::size_t i = 0; i < corpus.paths.size(); ++i) {
+            index->add(corpus.paths[i], corpus.fingerprints[i]);
+        }
+        index->build();
+    }
+
+    void Daemon::load_store_shard() {
+        if (options.shardCount == 0 || options.shardIndex >= options.shardCount) {
+            throw std::invalid_argument("shard index must be less than shard count.");
+        }
+        //只把本分片的文档复制进索引，映射的指纹文件在构造结束后释放。
+        //文档按指纹文件中的顺序（即路径顺序）加入，top_k按下标排列距离相同的文档，与协调器按文档标识合并的顺序一致
+        FingerprintStore store(options.storePath);
+        options.ngram = store.ngram();
+        segmenter = store.segmenter();
+        index = std::make_unique<SimHashIndex>(options.maxDistance);
+        for (std::size_t doc = options.shardIndex; doc < store.size(); doc += options.shardCount) {
+            index->add(std::string(store.doc_id(doc)), store.fingerprint(doc));
+        }
+        index->build();
+        std::cout << "shard " << options.shardIndex << "/" << options.shardCount
+                  << " documents: " << index->size() << std::endl;
+    }
+
+    std::size_t Daemon::payload_count(const std::string& command) {
+        std::string name = command_name(command);
+        if (name == "compare") {
+            return 2;
+        }
+        if (name == "query") {
+            return 1;
+        }
+        return 0;
+    }
+
+    std::string Daemon::handle(const std::string& command, const std::vector<std::string>& payloads) {
+        std::string name = command_name(command);
+        try {
+            if (name == "ping") {
+                return "ok\npong";
+            }
+            if (name == "compare") {
+                return "ok\n" + format_similarity(calcu_simi_cached(payloads[0], payloads[1], *cache, options.ngram));
+            }
+            if (name == "query") {
+                if (!index) {
+                    return "error\nno corpus index is loaded.";
+                }
+                if (Tokenizer::local().segmenter_id() != segmenter) {
+                    return "error\nindex was built with a different tokenizer engine or dictionary.";
+                }
+                std::istringstream args(command.substr(name.size()));
+                int k = options.maxDistance;
+                args >> k;
+                std::bitset<64> fingerprint = cached_fingerprint(payloads[0], options.ngram, cache.get()).fingerprint;
+                std::string body = "ok\n";
+                for (const auto& match : index->query(fingerprint, k)) {
+                    body += index->doc_id(match.doc) + " " + std::to_string(match.distance) + " " +
+                        format_similarity(similarity_from_distance(match.distance)) + "\n";
+                }
+                return body;
+            }
+            if (name == "topk") {
+                if (!index) {
+                    return "error\nno corpus index is loaded.";
+                }
+                std::istringstream args(command.substr(name.size()));
+                std::size_t k = 0;
+                std::string hex;
+                int ngram = options.ngram;
+                SegmenterId querySegmenter = segmenter;
+                if (!(args >> k >> hex)) {
+                    return "error\nusage: topk <k> <fingerprint> [ngram [engine dictionary]]";
+                }
+                args >> ngram >> querySegmenter.engine >> querySegmenter.dictionary;
+                if (ngram != options.ngram) {
+                    return "error\nindex uses ngram " + std::to_string(options.ngram) + ".";
+                }
+                if (querySegmenter != segmenter) {
+                    return "error\nindex was built with a different tokenizer engine or dictionary.";
+                }
+                std::string body = "ok\n";
+                for (const auto& match : index->top_k(decode_fingerprint(hex), k)) {
+                    body += index->doc_id(match.doc) + " " + std::to_string(match.distance) + " " +
+                        format_similarity(similarity_from_distance(match.distance)) + "\n";
+                }
+                return body;
+            }
+            if (name == "shutdown") {
+                stopping = true;
+                return "ok\nbye";
+            }
+            return "error\nunknown command: " + name;
+        }
+        catch (const std::exception& e) {
+            return std::string("error\n") + e.what();
+        }
+    }
+
+    void Daemon::serve_connection(LocalSocket& socket) {
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            if (stopping) {
+                --activeConnections;
+                return;
+            }
+            connections.insert(&socket);
+        }
+        try {
+            std::string command;
+            while (socket.recv_frame(command)) {
+                std::vector<std::string> payloads(payload_count(command));
+                for (auto& payload : payloads) {
+                    if (!socket.recv_frame(payload)) {
+                        throw std::runtime_error("connection closed inside a request.");
+                    }
+                }
+                socket.send_frame(handle(command, payloads));
+                if (stopping) {
+                    //连接一次自己的套接字，唤醒阻塞在accept上的主线程
+                    LocalSocket::connect(socketPath);
+                    break;
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            if (!stopping) {
+                std::cerr << e.what() << std::endl;
+            }
+        }
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        connections.erase(&socket);
+        --activeConnections;
+    }
+
+    void Daemon::serve(const std::string& path) {
+#ifndef _WIN32
+        //客户端提前断开时send返回错误，而不是让进程收到SIGPIPE
+        std::signal(SIGPIPE, SIG_IGN);
+#endif
+        socketPath = path;
+        LocalListener listener(path);
+        std::cout << "listening on " << path << std::endl;
+        {
+            WorkStealingPool pool(options.threads);
+            std::size_t maxConnections = options.maxConnections == 0 ? pool.size() : options.maxConnections;
+            while (!stopping) {
+                auto socket = std::make_shared<LocalSocket>(listener.accept());
+                if (stopping) {
+                    break;
+                }
+                //每个连接独占一个工作线程，超过上限的连接排队会无限期等待，直接拒绝
+                if (activeConnections >= maxConnections) {
+                    try {
+                        socket->send_frame("error\nserver busy: too many connections.");
+                    }
+                    catch (const std::exception&) {
+                    }
+                    continue;
+                }
+                socket->set_receive_timeout(options.idleTimeout);
+                ++activeConnections;
+                pool.submit([this, socket] {
+                    serve_connection(*socket);
+                });
+            }
+            //让仍保持连接的客户端从recv中返回，线程池才能结束
+            {
+                std::lock_guard<std::mutex> lock(connectionsMutex);
+                for (LocalSocket* connection : connections) {
+                    connection->shutdown();
+                }
+            }
+            pool.wait();
+        }
+        if (!options.cachePath.empty()) {
+            cache->save();
+        }
+    }
+
+    std::string daemon_request(LocalSocket& socket, const std::string& command, const std::vector<std::string_view>& payloads) {
+        if (payloads.size() != Daemon::payload_count(command)) {
+            throw std::invalid_argument("wrong number of payloads for command: " + command);
+        }
+        std::string response;
+        bool answered = false;
+        try {
+            socket.send_frame(command);
+            for (const auto& payload : payloads) {
+                socket.send_frame(payload);
+            }
+        }
+        catch (const std::runtime_error&) {
+            //服务繁忙时先回复error帧再关闭连接，请求发送失败，但回复仍可以读到
+            answered = socket.recv_frame(response);
+            if (!answered) {
+                throw;
+            }
+        }
+        if (!answered && !socket.recv_frame(response)) {
+            throw std::runtime_error("daemon closed the connection.");
+        }
+        std::size_t newline = response.find('\n');
+        std::string status = response.substr(0, newline);
+        std::string body = newline == std::string::npos ? "" : response.substr(newline + 1);
+        if (status != "ok") {
+            throw std::runtime_error("daemon error: " + body);
+        }
+        return body;
+    }
+
+    std::string encode_fingerprint(const std::bitset<64>& fingerprint) {
+        std::ostringstream oss;
+        oss << std::hex << std::setw(16) << std::setfill('0') << fingerprint.to_ullong();
+        return oss.str();
+    }
+
+    std::bitset<64> decode_fingerprint(const std::string& text) {
+        if (text.empty() || text.size() > 16 || text.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+            throw std::invalid_argument("invalid fingerprint: " + text);
+        }
+        return std::bitset<64>(std::stoull(text, nullptr, 16));
+    }
+}
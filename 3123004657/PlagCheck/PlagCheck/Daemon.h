@@ -0,0 +1,128 @@
+#pragma once
+#include "Socket.h"
+#include "SimHashIndex.h"
+#include "FingerprintCache.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 常驻服务的配置
+        @param ngram 以几个单词的n-gram为SimHash特征
+        @param corpusDir 启动时建立索引的语料库目录，为空时不支持query
+        @param maxDistance 语料库索引支持的最大汉明距离
+        @param cachePath 指纹缓存文件，为空时只使用内存缓存
+        @param threads 处理请求与启动时计算语料库指纹的线程数，0表示硬件线程数
+        @param storePath 启动时加载的指纹文件，非空时代替corpusDir建立索引，n-gram大小以文件为准
+        @param shardIndex 分片编号，只加载指纹文件中下标模shardCount等于shardIndex的文档
+        @param shardCount 分片总数
+        @param idleTimeout 连接上等待下一帧的最长秒数，超时后关闭连接并释放工作线程，0表示不超时
+        @param maxConnections 同时处理的连接数上限，为0时取线程池的线程数；超过时新连接收到error帧后被关闭
+        @param maxCacheEntries 内存中指纹缓存的记录数上限，超过时按时钟算法淘汰，0表示不限；
+                               每条记录约300多字节，默认上限约占几十MB
+    */
+    struct DaemonOptions {
+        int ngram = 1;
+        std::string corpusDir;
+        int maxDistance = 3;
+        std::string cachePath;
+        unsigned threads = 0;
+        std::string storePath;
+        std::size_t shardIndex = 0;
+        std::size_t shardCount = 1;
+        unsigned idleTimeout = 60;
+        std::size_t maxConnections = 0;
+        std::size_t maxCacheEntries = 100000;
+    };
+
+    /*
+        @brief 常驻查重服务
+        @details 进程启动时加载ICU分词器、建立语料库索引并打开指纹缓存，之后在本地套接字上
+                 反复处理请求，省去每次查重都要付出的进程启动与ICU初始化开销。
+                 每个连接交给线程池中的一个线程处理，一个连接上可以依次发送多个请求。
+                 连接在整个生命周期内占用一个工作线程，因此空闲超过idleTimeout的连接会被关闭，
+                 同时处理的连接数达到上限时新连接直接收到 "error\nserver busy" 而不是排队等待。
+                 协议以帧为单位（4字节小端长度 + 内容）：请求的第一帧是命令行，之后是命令需要的文本帧；
+                 响应只有一帧，第一行为 ok 或 error，其余为结果或错误信息。
+                     ping                    无文本帧，返回 pong
+                     compare                 原文、抄袭版两帧，返回相似度
+                     query [最大汉明距离]    待查文本一帧，每行返回 "文档 汉明距离 相似度"
+                     topk k 指纹 [n-gram [引擎 词典哈希]]
+                                             无文本帧，返回与十六进制指纹最接近的k篇文档，格式同query；
+                                             n-gram或分词配置（见SegmenterId）与索引不一致时返回error，供分片协调器使用
+                     shutdown                无文本帧，服务在回复后退出
+        @method serve 在套接字上提供服务，直到收到shutdown
+        @method handle 处理一个已经读完的请求
+    */
+    class Daemon {
+    public:
+        /*
+            @brief 构造函数，预热分词器、建立索引并打开缓存
+            @param options 服务配置
+            @throws runtime_error 如果语料库、指纹文件或缓存无法读取
+            @throws invalid_argument 如果shardIndex不小于shardCount
+        */
+        explicit Daemon(const DaemonOptions& options);
+
+        /*
+            @brief 监听套接字并处理请求，收到shutdown后返回
+            @param socketPath 套接字文件路径
+            @throws runtime_error 如果套接字无法监听
+        */
+        void serve(const std::string& socketPath);
+
+        /*
+            @brief 处理一个请求
+            @param command 命令行
+            @param payloads 文本帧
+            @return 返回响应帧内容
+        */
+        std::string handle(const std::string& command, const std::vector<std::string>& payloads);
+
+        /*
+            @brief 获取命令需要的文本帧数
+            @param command 命令行
+            @return 返回文本帧数，未知命令返回0
+        */
+        static std::size_t payload_count(const std::string& command);
+
+    private:
+        DaemonOptions options;
+        std::string socketPath;
+        std::unique_ptr<SimHashIndex> index;
+        SegmenterId segmenter;
+        std::unique_ptr<FingerprintCache> cache;
+        std::atomic<bool> stopping{ false };
+        std::atomic<std::size_t> activeConnections{ 0 };
+        std::mutex connectionsMutex;
+        std::set<LocalSocket*> connections;
+
+        void serve_connection(LocalSocket& socket);
+        void load_store_shard();
+    };
+
+    /*
+        @brief 客户端：发送一个请求并等待响应
+        @param socket 已连接到服务的套接字
+        @param command 命令行
+        @param payloads 文本帧
+        @return 返回响应中ok之后的内容
+        @throws runtime_error 如果服务返回error或连接断开
+    */
+    std::string daemon_request(LocalSocket& socket, const std::string& command, const std::vector<std::string_view>& payloads);
+
+    /*
+        @brief 把指纹编码为协议中使用的16位十六进制字符串
+    */
+    std::string encode_fingerprint(const std::bitset<64>& fingerprint);
+
+    /*
+        @brief 解析16位十六进制指纹
+        @throws invalid_argument 如果不是合法的十六进制指纹
+    */
+    std::bitset<64> decode_fingerprint(const std::string& text);
+}
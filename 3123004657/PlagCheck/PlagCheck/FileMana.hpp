@@ -6,6 +6,10 @@
 #include <sstream>
 #include <stdexcept>
 #include <filesystem>
+#include <memory>
+#include <string_view>
+#include "MappedFile.hpp"
+#include "Stats.h"
 
 /*
     @brief 文件管理类
@@ -21,6 +25,8 @@
     @method is_file_readable 检查文件是否可读
     @method is_file_writable 检查文件是否可写
     @method read_lines 读取文件内容，返回字符串
+    @method read_view 以内存映射方式读取文件内容，返回零拷贝的字符串视图
+    @method read_chunk 读取下一块内容到调用者的缓冲区
     @method write_lines 写入内容到文件
 */
 class FileManager
@@ -31,6 +37,8 @@ class FileManager
         bool isOpen = false;
         bool readable = false;
         bool writable = false;
+        std::unique_ptr<PlagCheck::MappedFile> mapping;
+        std::string viewBuffer;
 
     public:
         /*
@@ -109,12 +117,69 @@ class FileManager
             if (!is_file_readable()) {
                 throw std::runtime_error("File is not open for reading.");
             }
+            PlagCheck::ScopedTimer timer(PlagCheck::Phase::Read);
             std::stringstream buffer;
             buffer << fileStream.rdbuf();
             std::string content = buffer.str();
+            if (PlagCheck::Stats::enabled()) {
+                PlagCheck::Stats::add_bytes(content.size());
+            }
             return content;
         }
 
+        /*
+            @brief 以内存映射方式读取整个文件，不经过iostream复制
+            @details 普通文件直接映射并提示操作系统按顺序预读（madvise MADV_SEQUENTIAL）；
+                     管道等无法映射的文件退回到缓冲读取，内容保存在FileManager内部。
+                     返回的视图在FileManager析构或close_file之前有效。
+            @return 返回文件内容的字符串视图
+            @throws runtime_error 如果文件未打开或不可读
+        */
+        std::string_view read_view()
+        {
+            if (!is_file_readable()) {
+                throw std::runtime_error("File is not open for reading.");
+            }
+            if (mapping) {
+                return mapping->view();
+            }
+            PlagCheck::ScopedTimer timer(PlagCheck::Phase::Read);
+            try {
+                mapping = std::make_unique<PlagCheck::MappedFile>(filePath, true);
+            }
+            catch (const std::runtime_error&) {
+                std::stringstream buffer;
+                buffer << fileStream.rdbuf();
+                viewBuffer = buffer.str();
+            }
+            std::string_view content = mapping ? mapping->view() : std::string_view(viewBuffer);
+            if (PlagCheck::Stats::enabled()) {
+                PlagCheck::Stats::add_bytes(content.size());
+            }
+            return content;
+        }
+
+        /*
+            @brief 从当前位置读取至多size字节到缓冲区，用于分块处理大文件
+            @param buffer 目标缓冲区
+            @param size 缓冲区大小
+            @return 返回实际读取的字节数，为0表示已到文件末尾
+            @throws runtime_error 如果文件未打开或不可读
+        */
+        std::size_t read_chunk(char* buffer, std::size_t size)
+        {
+            if (!is_file_readable()) {
+                throw std::runtime_error("File is not open for reading.");
+            }
+            PlagCheck::ScopedTimer timer(PlagCheck::Phase::Read);
+            fileStream.read(buffer, static_cast<std::streamsize>(size));
+            std::size_t count = static_cast<std::size_t>(fileStream.gcount());
+            if (PlagCheck::Stats::enabled()) {
+                PlagCheck::Stats::add_bytes(count);
+            }
+            return count;
+        }
+
         /*
             @brief 写入内容到文件
             @param content 要写入的内容字符串
@@ -140,5 +205,7 @@ class FileManager
                 fileStream.close();
                 isOpen = false;
             }
+            mapping.reset();
+            viewBuffer.clear();
         }
 };
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "FingerprintCache.h"
+#include "Hashing.h"
+#include "PlagCheck.h"
+#include "Tokenizer.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace PlagCheck {
+
+    static const char cacheMagic[4] = { 'P', 'C', 'F', 'C' };
+    //版本2在记录中加入了分词引擎与词典哈希，旧文件的记录无法确定分词配置，直接拒绝
+    static const std::uint32_t cacheVersion = 2;
+
+    /*
+        @brief 缓存文件中一条记录的定长布局
+    */
+    struct CacheRecord {
+        std::uint64_t hash;
+        std::uint64_t size;
+        std::uint32_t ngram;
+        std::uint32_t engine;
+        std::uint64_t dictionary;
+        std::uint64_t words;
+        std::int32_t counters[64];
+        std::uint64_t fingerprint;
+    };
+
+    FingerprintCache::FingerprintCache(const std::string& path, std::size_t capacity)
+        : cachePath(path), capacity(capacity) {
+        std::ifstream in(path, std::ios_base::binary);
+        if (!in.is_open()) {
+            return;
+        }
+        char magic[4];
+        std::uint32_t version = 0;
+        std::uint64_t count = 0;
+        in.read(magic, sizeof(magic));
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!in || std::memcmp(magic, cacheMagic, sizeof(magic)) != 0 || version != cacheVersion) {
+            throw std::runtime_error("Invalid fingerprint cache: " + path);
+        }
+        CacheRecord record;
+        for (std::uint64_t i = 0; i < count; ++i) {
+            if (!in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+                throw std::runtime_error("Truncated fingerprint cache: " + path);
+            }
+            CacheEntry entry;
+            entry.words = record.words;
+            std::memcpy(entry.counters.data(), record.counters, sizeof(record.counters));
+            entry.fingerprint = std::bitset<64>(record.fingerprint);
+            if (capacity == 0 || entries.size() < capacity) {
+                insert({ record.hash, record.size, record.ngram, record.engine, record.dictionary }, entry);
+            }
+        }
+    }
+
+    ContentKey FingerprintCache::key_of(std::string_view content, int ngram, const SegmenterId& segmenter) {
+        return { xxhash64(content), static_cast<std::uint64_t>(content.size()), static_cast<std::uint32_t>(ngram),
+            segmenter.engine, segmenter.dictionary };
+    }
+
+    bool FingerprintCache::lookup(const ContentKey& key, CacheEntry& entry) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            return false;
+        }
+        entry = it->second.entry;
+        it->second.referenced = true;
+        return true;
+    }
+
+    void FingerprintCache::insert(const ContentKey& key, const CacheEntry& entry) {
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            it->second.entry = entry;
+            return;
+        }
+        if (capacity == 0) {
+            entries[key].entry = entry;
+            return;
+        }
+        if (ring.size() < capacity) {
+            ring.push_back(key);
+        }
+        else {
+            //跳过并清除最近命中过的记录，淘汰指针处第一条未命中的记录，新记录占用它的位置
+            while (entries.at(ring[hand]).referenced) {
+                entries.at(ring[hand]).referenced = false;
+                hand = (hand + 1) % capacity;
+            }
+            entries.erase(ring[hand]);
+            ring[hand] = key;
+            hand = (hand + 1) % capacity;
+        }
+        entries[key].entry = entry;
+    }
+
+    void FingerprintCache::store(const ContentKey& key, const CacheEntry& entry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        insert(key, entry);
+        dirty = true;
+    }
+
+    void FingerprintCache::save() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!dirty) {
+            return;
+        }
+        //先写入临时文件再替换，避免中途失败留下损坏的缓存
+        std::string tempPath = cachePath + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios_base::binary | std::ios_base::trunc);
+            if (!out.is_open()) {
+                throw std::runtime_error("Failed to open fingerprint cache for writing: " + tempPath);
+            }
+            std::uint64_t count = entries.size();
+            out.write(cacheMagic, sizeof(cacheMagic));
+            out.write(reinterpret_cast<const char*>(&cacheVersion), sizeof(cacheVersion));
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (const auto& item : entries) {
+                CacheRecord record = {};
+                record.hash = item.first.hash;
+                record.size = item.first.size;
+                record.ngram = item.first.ngram;
+                record.engine = item.first.engine;
+                record.dictionary = item.first.dictionary;
+                record.words = item.second.entry.words;
+                std::memcpy(record.counters, item.second.entry.counters.data(), sizeof(record.counters));
+                record.fingerprint = item.second.entry.fingerprint.to_ullong();
+                out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            }
+            if (!out) {
+                throw std::runtime_error("Failed to write fingerprint cache: " + tempPath);
+            }
+        }
+        std::filesystem::rename(tempPath, cachePath);
+    }
+
+    std::size_t FingerprintCache::size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    CacheEntry cached_fingerprint(std::string_view content, int ngram, FingerprintCache* cache) {
+        CacheEntry entry;
+        ContentKey key = {};
+        Tokenizer& tokenizer = Tokenizer::local();
+        if (cache != nullptr) {
+            key = FingerprintCache::key_of(content, ngram, tokenizer.segmenter_id());
+            if (cache->lookup(key, entry)) {
+                return entry;
+            }
+        }
+        thread_local std::vector<std::string_view> words;
+        tokenizer.tokenize(content, words);
+        SimHashAccumulator accumulator;
+        accumulate_simhash(words, ngram, accumulator);
+        entry.words = words.size();
+        entry.counters = accumulator.counters();
+        entry.fingerprint = accumulator.fingerprint();
+        if (cache != nullptr) {
+            cache->store(key, entry);
+        }
+        return entry;
+    }
+
+    double calcu_simi_cached(std::string_view original, std::string_view copyed, FingerprintCache& cache,
+        int ngram) {
+        if (original.empty() || copyed.empty()) {
+            return 0.00;
+        }
+        //逐字节相同的内容无需任何计算
+        if (original == copyed) {
+            return 1.00;
+        }
+        CacheEntry org = cached_fingerprint(original, ngram, &cache);
+        CacheEntry cop = cached_fingerprint(copyed, ngram, &cache);
+        if (org.words == 0 || cop.words == 0) {
+            return 0.00;
+        }
+        return similarity_from_distance(hamming_distance(org.fingerprint, cop.fingerprint));
+    }
+}
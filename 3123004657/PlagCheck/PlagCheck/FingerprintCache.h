@@ -0,0 +1,155 @@
+#pragma once
+#include "SimHashKernel.h"
+#include "Tokenizer.h"
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 文件内容的缓存键
+        @param hash 文件内容的xxHash64值
+        @param size 文件字节数
+        @param ngram 计算指纹时使用的n-gram大小
+        @param engine 计算指纹时使用的分词引擎
+        @param dictionary Dictionary引擎所用词典的内容哈希，其他引擎为0
+    */
+    struct ContentKey {
+        std::uint64_t hash;
+        std::uint64_t size;
+        std::uint32_t ngram;
+        std::uint32_t engine;
+        std::uint64_t dictionary;
+
+        bool operator==(const ContentKey& other) const
+        {
+            return hash == other.hash && size == other.size && ngram == other.ngram &&
+                engine == other.engine && dictionary == other.dictionary;
+        }
+    };
+
+    /*
+        @brief 一条缓存记录
+        @param words 文档的单词数
+        @param counters SimHash的64个计数器
+        @param fingerprint 最终的SimHash值
+    */
+    struct CacheEntry {
+        std::uint64_t words;
+        std::array<std::int32_t, 64> counters;
+        std::bitset<64> fingerprint;
+    };
+
+    /*
+        @brief 以文件内容哈希为键的指纹缓存
+        @details 内容未变化的文件直接命中缓存，跳过分词与哈希。键包含n-gram大小与分词配置，
+                 不同引擎或词典算出的指纹互不混用。缓存保存在单个文件中，
+                 构造时加载，save时整体重写。lookup与store可以在多个线程中同时调用。
+                 给出容量时按时钟（clock）算法淘汰：命中的记录被标记，写入新记录而缓存已满时，
+                 指针依次清除标记，淘汰第一条未被标记的记录，常驻进程的缓存不会无限增长。
+        @method key_of 计算文件内容的缓存键
+        @method lookup 查找缓存记录
+        @method store 写入缓存记录
+        @method save 保存到文件
+    */
+    class FingerprintCache {
+    public:
+        /*
+            @brief 构造函数，缓存文件存在时加载其内容
+            @param path 缓存文件路径
+            @param capacity 最多保存的记录数，0表示不限；文件中的记录超过容量时只保留先读到的部分
+            @throws runtime_error 如果缓存文件存在但格式不正确
+        */
+        explicit FingerprintCache(const std::string& path, std::size_t capacity = 0);
+
+        /*
+            @brief 计算文件内容的缓存键
+            @param content 文件内容
+            @param ngram 计算指纹时使用的n-gram大小
+            @param segmenter 计算指纹时使用的分词配置
+            @return 返回缓存键
+        */
+        static ContentKey key_of(std::string_view content, int ngram, const SegmenterId& segmenter);
+
+        /*
+            @brief 查找缓存记录
+            @param key 缓存键
+            @param entry 命中时写入缓存记录
+            @return 命中返回true，否则返回false
+        */
+        bool lookup(const ContentKey& key, CacheEntry& entry) const;
+
+        /*
+            @brief 写入缓存记录，缓存已满时先淘汰一条记录
+            @param key 缓存键
+            @param entry 缓存记录
+        */
+        void store(const ContentKey& key, const CacheEntry& entry);
+
+        /*
+            @brief 若有新记录则保存到缓存文件
+            @throws runtime_error 如果文件无法写入
+        */
+        void save() const;
+
+        /*
+            @brief 获取缓存记录数
+        */
+        std::size_t size() const;
+
+    private:
+        struct KeyHash {
+            std::size_t operator()(const ContentKey& key) const
+            {
+                return static_cast<std::size_t>(key.hash ^ (key.size * 0x9E3779B97F4A7C15ULL) ^ key.ngram ^
+                    (static_cast<std::uint64_t>(key.engine) << 8) ^ (key.dictionary * 0xC2B2AE3D27D4EB4FULL));
+            }
+        };
+
+        /*
+            @brief 一条记录及其时钟标记，lookup命中时置位
+        */
+        struct Slot {
+            CacheEntry entry;
+            mutable bool referenced = false;
+        };
+
+        std::string cachePath;
+        std::size_t capacity;
+        mutable std::mutex mutex;
+        bool dirty = false;
+        std::unordered_map<ContentKey, Slot, KeyHash> entries;
+        std::vector<ContentKey> ring;
+        std::size_t hand = 0;
+
+        void insert(const ContentKey& key, const CacheEntry& entry);
+    };
+
+    /*
+        @brief 计算文本的缓存记录，命中缓存时跳过分词
+        @details 用当前线程的Tokenizer分词，缓存键中的分词配置取自它的 segmenter_id
+        @param content 文本内容
+        @param ngram n-gram中的单词数，取值[1, 5]
+        @param cache 指纹缓存，为nullptr时总是重新计算
+        @return 返回单词数、计数器与SimHash值
+    */
+    CacheEntry cached_fingerprint(std::string_view content, int ngram, FingerprintCache* cache);
+
+    /*
+        @brief 借助指纹缓存计算两个字符串的相似度
+        @details 两段内容逐字节相同时直接返回1.00；否则对每段内容先查缓存，未命中才分词计算，
+                 结果与calcu_simi相同。
+        @param original 原文字符串
+        @param copyed 被查重文章的字符串
+        @param cache 指纹缓存
+        @param ngram 以几个单词的n-gram为特征，取值[1, 5]
+        @return 返回字符串的相似度
+    */
+    double calcu_simi_cached(std::string_view original, std::string_view copyed, FingerprintCache& cache,
+        int ngram = 1);
+}
@@ -0,0 +1,138 @@
+#include "FingerprintStore.h"
+#include "Shingle.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    static const char storeMagic[4] = { 'P', 'C', 'F', 'P' };
+
+    void save_fingerprint_store(const std::string& path, const std::vector<std::string>& docIds,
+        const std::vector<std::bitset<64>>& fingerprints, int ngram, const SegmenterId& segmenter) {
+        if (docIds.size() != fingerprints.size()) {
+            throw std::invalid_argument("docIds and fingerprints must have the same length.");
+        }
+        FingerprintStoreHeader header = {};
+        std::memcpy(header.magic, storeMagic, sizeof(storeMagic));
+        header.version = FingerprintStore::currentVersion;
+        header.hashId = FingerprintStore::xxhash64SimHash;
+        header.ngram = static_cast<std::uint32_t>(ngram);
+        header.engine = segmenter.engine;
+        header.dictionary = segmenter.dictionary;
+        header.count = docIds.size();
+        header.fingerprintOffset = sizeof(FingerprintStoreHeader);
+        header.idOffsetOffset = header.fingerprintOffset + header.count * sizeof(std::uint64_t);
+        header.idDataOffset = header.idOffsetOffset + (header.count + 1) * sizeof(std::uint64_t);
+
+        std::vector<std::uint64_t> packed(fingerprints.size());
+        for (std::size_t i = 0; i < fingerprints.size(); ++i) {
+            packed[i] = fingerprints[i].to_ullong();
+        }
+        std::vector<std::uint64_t> offsets;
+        offsets.reserve(docIds.size() + 1);
+        std::uint64_t offset = 0;
+        for (const auto& id : docIds) {
+            offsets.push_back(offset);
+            offset += id.size();
+        }
+        offsets.push_back(offset);
+
+        std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open fingerprint store for writing: " + path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(packed.data()),
+            static_cast<std::streamsize>(packed.size() * sizeof(std::uint64_t)));
+        out.write(reinterpret_cast<const char*>(offsets.data()),
+            static_cast<std::streamsize>(offsets.size() * sizeof(std::uint64_t)));
+        for (const auto& id : docIds) {
+            out.write(id.data(), static_cast<std::streamsize>(id.size()));
+        }
+        if (!out) {
+            throw std::runtime_error("Failed to write fingerprint store: " + path);
+        }
+    }
+
+    /*
+        @brief 判断从offset开始的count个size字节的元素是否都在文件范围内，不会发生整数溢出
+    */
+    static bool section_fits(std::uint64_t offset, std::uint64_t count, std::uint64_t size, std::uint64_t fileSize) {
+        return offset <= fileSize && count <= (fileSize - offset) / size;
+    }
+
+    FingerprintStore::FingerprintStore(const std::string& path)
+        : file(path) {
+        if (file.size() < sizeof(FingerprintStoreHeader)) {
+            throw std::runtime_error("Invalid fingerprint store: " + path);
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, storeMagic, sizeof(storeMagic)) != 0) {
+            throw std::runtime_error("Invalid fingerprint store: " + path);
+        }
+        if (header.version != currentVersion || header.hashId != xxhash64SimHash) {
+            throw std::runtime_error("Unsupported fingerprint store version: " + path);
+        }
+        //n-gram大小决定查询指纹的计算方式，超出范围时在这里拒绝，而不是等到查询时才失败
+        if (header.ngram < 1 || header.ngram > static_cast<std::uint32_t>(ShingleRoller::maxSize)) {
+            throw std::runtime_error("Invalid fingerprint store: " + path);
+        }
+        //校验各段都在文件范围内，避免读取越界；count不超过文件的8字节数，count + 1不会溢出
+        std::uint64_t fileSize = file.size();
+        if (header.count >= fileSize / sizeof(std::uint64_t) ||
+            header.fingerprintOffset % sizeof(std::uint64_t) != 0 ||
+            header.idOffsetOffset % sizeof(std::uint64_t) != 0 ||
+            !section_fits(header.fingerprintOffset, header.count, sizeof(std::uint64_t), fileSize) ||
+            !section_fits(header.idOffsetOffset, header.count + 1, sizeof(std::uint64_t), fileSize) ||
+            header.idDataOffset > fileSize) {
+            throw std::runtime_error("Corrupted fingerprint store: " + path);
+        }
+        packed = reinterpret_cast<const std::uint64_t*>(file.data() + header.fingerprintOffset);
+        idOffsets = reinterpret_cast<const std::uint64_t*>(file.data() + header.idOffsetOffset);
+        idData = file.data() + header.idDataOffset;
+        //doc_id用相邻偏移之差作为长度，偏移必须单调不减且不超过标识数据段的末尾
+        std::uint64_t idDataSize = fileSize - header.idDataOffset;
+        for (std::uint64_t doc = 0; doc < header.count; ++doc) {
+            if (idOffsets[doc] > idOffsets[doc + 1]) {
+                throw std::runtime_error("Corrupted fingerprint store: " + path);
+            }
+        }
+        if (idOffsets[header.count] > idDataSize) {
+            throw std::runtime_error("Corrupted fingerprint store: " + path);
+        }
+    }
+
+    std::size_t FingerprintStore::size() const {
+        return static_cast<std::size_t>(header.count);
+    }
+
+    int FingerprintStore::ngram() const {
+        return static_cast<int>(header.ngram);
+    }
+
+    SegmenterId FingerprintStore::segmenter() const {
+        SegmenterId id;
+        id.engine = header.engine;
+        id.dictionary = header.dictionary;
+        return id;
+    }
+
+    void FingerprintStore::check_segmenter(const SegmenterId& segmenter) const {
+        if (segmenter != this->segmenter()) {
+            throw std::runtime_error("The fingerprint store was built with a different tokenizer engine or dictionary.");
+        }
+    }
+
+    std::bitset<64> FingerprintStore::fingerprint(std::size_t doc) const {
+        return std::bitset<64>(packed[doc]);
+    }
+
+    std::string_view FingerprintStore::doc_id(std::size_t doc) const {
+        return std::string_view(idData + idOffsets[doc], static_cast<std::size_t>(idOffsets[doc + 1] - idOffsets[doc]));
+    }
+
+    const std::uint64_t* FingerprintStore::fingerprints() const {
+        return packed;
+    }
+}
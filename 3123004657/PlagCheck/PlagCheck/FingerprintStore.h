@@ -0,0 +1,128 @@
+#pragma once
+#include "MappedFile.hpp"
+#include "Tokenizer.h"
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 指纹文件的文件头
+        @details 文件布局（小端序）：文件头 | count个64位指纹 | count+1个64位文档标识偏移 | 文档标识字符串。
+                 指纹由 string_hash（xxHash64，种子0）与 compute_simhash 生成，hashId 记录所用算法，
+                 因此MSVC与Linux上生成的文件可以互相读取。engine 与 dictionary 记录生成指纹时的分词配置，
+                 查询指纹必须用相同的配置计算，否则距离没有意义。
+        @param magic 固定为 "PCFP"
+        @param version 文件格式版本
+        @param hashId 指纹算法标识，1表示xxHash64单词哈希的64位SimHash
+        @param ngram 生成指纹时使用的n-gram大小
+        @param engine 生成指纹时使用的分词引擎
+        @param reserved 保留，为0
+        @param dictionary Dictionary引擎所用词典的内容哈希，其他引擎为0
+        @param count 文档数
+        @param fingerprintOffset 指纹数组在文件中的偏移
+        @param idOffsetOffset 文档标识偏移表在文件中的偏移
+        @param idDataOffset 文档标识字符串在文件中的偏移
+    */
+    struct FingerprintStoreHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t hashId;
+        std::uint32_t ngram;
+        std::uint32_t engine;
+        std::uint32_t reserved;
+        std::uint64_t dictionary;
+        std::uint64_t count;
+        std::uint64_t fingerprintOffset;
+        std::uint64_t idOffsetOffset;
+        std::uint64_t idDataOffset;
+    };
+
+    /*
+        @brief 写入指纹文件
+        @param path 文件路径
+        @param docIds 文档标识
+        @param fingerprints 与docIds一一对应的SimHash值
+        @param ngram 生成指纹时使用的n-gram大小
+        @param segmenter 生成指纹时使用的分词配置
+        @throws invalid_argument 如果两个数组长度不同
+        @throws runtime_error 如果文件无法写入
+    */
+    void save_fingerprint_store(const std::string& path, const std::vector<std::string>& docIds,
+        const std::vector<std::bitset<64>>& fingerprints, int ngram, const SegmenterId& segmenter);
+
+    /*
+        @brief 内存映射的只读指纹文件
+        @details 打开时校验文件头（包括n-gram大小在[1, 5]之间）与文档标识的偏移表（各段在文件范围内、偏移单调不减），
+                 不复制数据，指纹和文档标识直接从映射的内存中读取，
+                 因此即使包含数百万篇文档也能立即加载。
+        @method size 获取文档数
+        @method check_segmenter 确认查询使用的分词配置与生成指纹时相同
+        @method fingerprint 获取文档指纹
+        @method doc_id 获取文档标识
+        @method fingerprints 获取连续的64位指纹数组
+    */
+    class FingerprintStore {
+    public:
+        static const std::uint32_t currentVersion = 2;
+        static const std::uint32_t xxhash64SimHash = 1;
+
+        /*
+            @brief 构造函数，映射并校验指纹文件
+            @param path 文件路径
+            @throws runtime_error 如果文件无法打开或格式不正确
+        */
+        explicit FingerprintStore(const std::string& path);
+
+        /*
+            @brief 获取文档数
+        */
+        std::size_t size() const;
+
+        /*
+            @brief 获取生成指纹时使用的n-gram大小
+        */
+        int ngram() const;
+
+        /*
+            @brief 获取生成指纹时使用的分词配置
+        */
+        SegmenterId segmenter() const;
+
+        /*
+            @brief 确认查询指纹使用的分词配置与生成指纹时相同
+            @param segmenter 查询使用的分词配置
+            @throws runtime_error 如果分词引擎或词典不同
+        */
+        void check_segmenter(const SegmenterId& segmenter) const;
+
+        /*
+            @brief 获取文档指纹
+            @param doc 文档下标
+            @return 返回文档的SimHash值
+        */
+        std::bitset<64> fingerprint(std::size_t doc) const;
+
+        /*
+            @brief 获取文档标识
+            @param doc 文档下标
+            @return 返回指向映射内存的文档标识
+        */
+        std::string_view doc_id(std::size_t doc) const;
+
+        /*
+            @brief 获取连续的64位指纹数组，长度为size()
+        */
+        const std::uint64_t* fingerprints() const;
+
+    private:
+        MappedFile file;
+        FingerprintStoreHeader header;
+        const std::uint64_t* packed = nullptr;
+        const std::uint64_t* idOffsets = nullptr;
+        const char* idData = nullptr;
+    };
+}
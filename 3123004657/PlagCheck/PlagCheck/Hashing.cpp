@@ -0,0 +1,97 @@
+#include "Hashing.h"
+#include <cstring>
+
+namespace PlagCheck {
+
+    static const std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    static const std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static const std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+    static const std::uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    static const std::uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+    static std::uint64_t rotl64(std::uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    /*
+        @brief 按小端序读取64位整数
+    */
+    static std::uint64_t read64(const unsigned char* p) {
+        std::uint64_t value = 0;
+        for (int i = 7; i >= 0; --i) {
+            value = (value << 8) | p[i];
+        }
+        return value;
+    }
+
+    /*
+        @brief 按小端序读取32位整数
+    */
+    static std::uint32_t read32(const unsigned char* p) {
+        return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+            (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+    }
+
+    static std::uint64_t round(std::uint64_t acc, std::uint64_t input) {
+        acc += input * prime2;
+        acc = rotl64(acc, 31);
+        return acc * prime1;
+    }
+
+    static std::uint64_t merge_round(std::uint64_t acc, std::uint64_t value) {
+        acc ^= round(0, value);
+        return acc * prime1 + prime4;
+    }
+
+    std::uint64_t xxhash64(std::string_view data, std::uint64_t seed) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+        const unsigned char* end = p + data.size();
+        std::uint64_t hash;
+        if (data.size() >= 32) {
+            std::uint64_t v1 = seed + prime1 + prime2;
+            std::uint64_t v2 = seed + prime2;
+            std::uint64_t v3 = seed;
+            std::uint64_t v4 = seed - prime1;
+            const unsigned char* limit = end - 32;
+            do {
+                v1 = round(v1, read64(p));
+                v2 = round(v2, read64(p + 8));
+                v3 = round(v3, read64(p + 16));
+                v4 = round(v4, read64(p + 24));
+                p += 32;
+            } while (p <= limit);
+            hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+            hash = merge_round(hash, v1);
+            hash = merge_round(hash, v2);
+            hash = merge_round(hash, v3);
+            hash = merge_round(hash, v4);
+        }
+        else {
+            hash = seed + prime5;
+        }
+        hash += static_cast<std::uint64_t>(data.size());
+
+        while (p + 8 <= end) {
+            hash ^= round(0, read64(p));
+            hash = rotl64(hash, 27) * prime1 + prime4;
+            p += 8;
+        }
+        if (p + 4 <= end) {
+            hash ^= static_cast<std::uint64_t>(read32(p)) * prime1;
+            hash = rotl64(hash, 23) * prime2 + prime3;
+            p += 4;
+        }
+        while (p < end) {
+            hash ^= static_cast<std::uint64_t>(*p) * prime5;
+            hash = rotl64(hash, 11) * prime1;
+            ++p;
+        }
+
+        hash ^= hash >> 33;
+        hash *= prime2;
+        hash ^= hash >> 29;
+        hash *= prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace PlagCheck {
+    /*
+        @brief splitmix64 混合函数
+        @details 把一个64位值打散为均匀分布的64位值，用于由一个哈希值派生多个独立哈希
+                 （Count-Min Sketch的行、MinHash的桶、n-gram哈希的最终混合等）。
+        @param x 输入值
+        @return 返回混合后的值
+    */
+    inline std::uint64_t mix64(std::uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    /*
+        @brief 计算xxHash64哈希值
+        @details 按xxHash64规范实现（按小端序读取输入），相同输入与种子在任何平台、
+                 任何编译器上都得到相同的结果，可用于持久化的指纹。
+        @param data 输入数据
+        @param seed 种子
+        @return 返回64位哈希值
+    */
+    std::uint64_t xxhash64(std::string_view data, std::uint64_t seed = 0);
+}
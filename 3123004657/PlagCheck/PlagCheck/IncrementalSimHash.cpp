@@ -0,0 +1,168 @@
+#include "IncrementalSimHash.h"
+#include "PlagCheck.h"
+#include "Shingle.h"
+#include "TextBoundary.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    //向两侧寻找上下文时第一次跨越的字节数，不够n-1个单词时加倍
+    static const std::size_t contextStep = 256;
+
+    /*
+        @brief 判断pos是否位于UTF-8字符的边界上
+    */
+    static bool is_char_boundary(std::string_view text, std::size_t pos) {
+        return pos == 0 || pos >= text.size() || (static_cast<unsigned char>(text[pos]) & 0xC0) != 0x80;
+    }
+
+    IncrementalSimHash::IncrementalSimHash(std::string_view text, int ngram)
+        : ngram(ngram), content(text) {
+        if (ngram < 1 || ngram > ShingleRoller::maxSize) {
+            throw std::invalid_argument("shingle size must be in [1, 5].");
+        }
+        recompute();
+    }
+
+    void IncrementalSimHash::recompute() {
+        Tokenizer::local().tokenize(content, windowWords);
+        simhash.reset();
+        accumulate_simhash(windowWords, ngram, simhash);
+        wordCount = windowWords.size();
+        rescanned = content.size();
+    }
+
+    /*
+        @brief 把 [contextBegin, contextEnd) 分三段分词，按顺序写入windowWords
+        @return 返回中间段 [left, right) 的单词数
+    */
+    std::size_t IncrementalSimHash::tokenize_window(std::size_t contextBegin, std::size_t left, std::size_t right,
+        std::size_t contextEnd) {
+        std::string_view text(content);
+        Tokenizer& tokenizer = Tokenizer::local();
+        windowWords.clear();
+        std::size_t middle = 0;
+        const std::size_t bounds[4] = { contextBegin, left, right, contextEnd };
+        for (int part = 0; part < 3; ++part) {
+            tokenizer.tokenize(text.substr(bounds[part], bounds[part + 1] - bounds[part]), segmentWords);
+            windowWords.insert(windowWords.end(), segmentWords.begin(), segmentWords.end());
+            if (part == 1) {
+                middle = segmentWords.size();
+            }
+        }
+        return middle;
+    }
+
+    void IncrementalSimHash::replace(std::size_t offset, std::size_t length, std::string_view replacement) {
+        if (offset > content.size()) {
+            throw std::out_of_range("replace offset is beyond the end of the document.");
+        }
+        length = std::min(length, content.size() - offset);
+        std::string_view text(content);
+        std::size_t end = offset + length;
+        if (!is_char_boundary(text, offset) || !is_char_boundary(text, end)) {
+            throw std::invalid_argument("replace range must not split a UTF-8 character.");
+        }
+
+        //修改范围扩展到安全切分点：左端由offset之前的字符决定，右端由end之后的字符决定，修改后依然成立
+        std::size_t left = last_safe_break(text.substr(0, offset));
+        std::size_t right = end == text.size() ? end : end + next_safe_break(text.substr(end), 1);
+
+        //n-gram需要两侧各至少n-1个单词的上下文，不足时继续向外扩展，直到文档开头或结尾
+        std::size_t need = static_cast<std::size_t>(ngram - 1);
+        Tokenizer& tokenizer = Tokenizer::local();
+        std::size_t contextBegin = left;
+        for (std::size_t step = contextStep; need > 0 && contextBegin > 0; step *= 2) {
+            contextBegin = step >= left ? 0 : last_safe_break(text.substr(0, left - step));
+            tokenizer.tokenize(text.substr(contextBegin, left - contextBegin), segmentWords);
+            if (segmentWords.size() >= need) {
+                break;
+            }
+        }
+        std::size_t contextEnd = right;
+        for (std::size_t step = contextStep; need > 0 && contextEnd < text.size(); step *= 2) {
+            contextEnd = step >= text.size() - right
+                ? text.size() : right + step + next_safe_break(text.substr(right + step), 1);
+            tokenizer.tokenize(text.substr(right, contextEnd - right), segmentWords);
+            if (segmentWords.size() >= need) {
+                break;
+            }
+        }
+
+        //旧片段的n-gram在修改文本之前累加，windowWords中的视图指向旧文本。
+        //片段中的单词不足n个时其中没有完整的n-gram（上下文已到达文档边界，或修改处没有单词）
+        std::size_t oldMiddle = tokenize_window(contextBegin, left, right, contextEnd);
+        SimHashAccumulator removed;
+        if (windowWords.size() >= static_cast<std::size_t>(ngram)) {
+            accumulate_simhash(windowWords, ngram, removed);
+        }
+
+        content.replace(offset, length, replacement);
+        //修改点之后的位置整体移动 replacement.size() - length，无符号回绕后相加结果仍然正确
+        std::size_t delta = replacement.size() - length;
+        std::size_t newMiddle = tokenize_window(contextBegin, left, right + delta, contextEnd + delta);
+        std::uint64_t newCount = wordCount - oldMiddle + newMiddle;
+        std::size_t window = contextEnd + delta - contextBegin;
+
+        //单词数不足n个的文档整体作为一个n-gram，无法增量维护
+        if (wordCount < static_cast<std::uint64_t>(ngram) || newCount < static_cast<std::uint64_t>(ngram)) {
+            recompute();
+            return;
+        }
+        SimHashAccumulator added;
+        if (windowWords.size() >= static_cast<std::size_t>(ngram)) {
+            accumulate_simhash(windowWords, ngram, added);
+        }
+        simhash.subtract(removed);
+        simhash.merge(added);
+        wordCount = newCount;
+        rescanned = (contextEnd - contextBegin) + window;
+    }
+
+    void IncrementalSimHash::assign(std::string_view newText) {
+        std::string_view text(content);
+        std::size_t limit = std::min(text.size(), newText.size());
+        std::size_t prefix = 0;
+        while (prefix < limit && text[prefix] == newText[prefix]) {
+            ++prefix;
+        }
+        std::size_t suffix = 0;
+        while (suffix < limit - prefix && text[text.size() - 1 - suffix] == newText[newText.size() - 1 - suffix]) {
+            ++suffix;
+        }
+        //不同之处可能从一个多字节字符的中间开始，两端退回到完整字符的边界
+        while (prefix > 0 && (!is_char_boundary(text, prefix) || !is_char_boundary(newText, prefix))) {
+            --prefix;
+        }
+        while (suffix > 0 && !is_char_boundary(text, text.size() - suffix)) {
+            --suffix;
+        }
+        if (prefix == text.size() && prefix == newText.size()) {
+            rescanned = 0;
+            return;
+        }
+        replace(prefix, text.size() - prefix - suffix, newText.substr(prefix, newText.size() - prefix - suffix));
+    }
+
+    std::bitset<64> IncrementalSimHash::fingerprint() const {
+        return simhash.fingerprint();
+    }
+
+    std::uint64_t IncrementalSimHash::words() const {
+        return wordCount;
+    }
+
+    const std::array<std::int32_t, 64>& IncrementalSimHash::counters() const {
+        return simhash.counters();
+    }
+
+    const std::string& IncrementalSimHash::text() const {
+        return content;
+    }
+
+    std::size_t IncrementalSimHash::last_rescanned_bytes() const {
+        return rescanned;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "SimHashKernel.h"
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 可增量更新的文档SimHash
+        @details 保存文档文本、单词数与64个有符号计数器。修改文档时只重新分词修改位置附近的片段：
+                 修改范围先向两侧扩展到安全切分点（见TextBoundary.h），在这些位置切开分别分词与整体分词结果相同；
+                 n大于1时再向两侧各多取至少n-1个单词作为上下文，使所有包含被修改单词的n-gram都落在片段内。
+                 从计数器中减去旧片段的全部n-gram、加上新片段的全部n-gram，片段两端上下文中的n-gram一减一加正好抵消。
+                 分词与哈希的工作量与修改的大小成正比，与文档长度无关；只有文本本身的拼接需要移动修改点之后的字节。
+                 文档单词数不足n个时整篇重新计算，与compute_simhash把整个序列作为一个n-gram的规则一致。
+                 任何时候 fingerprint() 都与对当前文本调用 compute_fingerprint 的结果相同。
+                 使用当前线程的Tokenizer，不是线程安全的。
+        @method replace 把一段文本替换为新文本
+        @method assign 把文档整体更新为新文本，只处理与当前文本不同的部分
+        @method fingerprint 获取SimHash值
+    */
+    class IncrementalSimHash {
+    public:
+        /*
+            @brief 构造函数，对初始文本完整计算一次
+            @param text 文档的初始文本
+            @param ngram n-gram中的单词数，取值[1, 5]
+            @throws invalid_argument 如果ngram不在[1, 5]之间
+        */
+        explicit IncrementalSimHash(std::string_view text = {}, int ngram = 1);
+
+        /*
+            @brief 把 [offset, offset + length) 的文本替换为replacement
+            @param offset 替换的起始字节
+            @param length 被替换的字节数，超出文本末尾的部分被忽略
+            @param replacement 新文本，UTF-8编码
+            @throws out_of_range 如果offset超过文本长度
+            @throws invalid_argument 如果替换范围的任一端位于多字节UTF-8字符的中间
+        */
+        void replace(std::size_t offset, std::size_t length, std::string_view replacement);
+
+        /*
+            @brief 把文档更新为newText
+            @details 去掉与当前文本相同的前缀与后缀，剩余部分作为一次replace，
+                     适用于只改动了几段的重新提交
+            @param newText 新的文档文本
+        */
+        void assign(std::string_view newText);
+
+        /*
+            @brief 获取SimHash值
+        */
+        std::bitset<64> fingerprint() const;
+
+        /*
+            @brief 获取文档的单词数
+        */
+        std::uint64_t words() const;
+
+        /*
+            @brief 获取64个计数器
+        */
+        const std::array<std::int32_t, 64>& counters() const;
+
+        /*
+            @brief 获取当前文本
+        */
+        const std::string& text() const;
+
+        /*
+            @brief 获取最近一次修改重新分词的字节数，用于观察增量更新的工作量
+        */
+        std::size_t last_rescanned_bytes() const;
+
+    private:
+        int ngram;
+        std::string content;
+        SimHashAccumulator simhash;
+        std::uint64_t wordCount = 0;
+        std::size_t rescanned = 0;
+        std::vector<std::string_view> windowWords;
+        std::vector<std::string_view> segmentWords;
+
+        void recompute();
+        std::size_t tokenize_window(std::size_t contextBegin, std::size_t left, std::size_t right,
+            std::size_t contextEnd);
+    };
+}
@@ -0,0 +1,177 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PlagCheck {
+    /*
+        @brief 只读内存映射文件
+        @details 构造时把整个文件映射到内存，析构时解除映射；
+                 Windows下使用CreateFileMapping，其他平台使用mmap。
+        @method data 获取映射的起始地址
+        @method size 获取文件大小
+        @method view 以string_view形式访问文件内容
+    */
+    class MappedFile {
+    private:
+        const char* mapped = nullptr;
+        std::size_t length = 0;
+#if defined(_WIN32)
+        HANDLE fileHandle = INVALID_HANDLE_VALUE;
+        HANDLE mappingHandle = nullptr;
+#endif
+
+        void release()
+        {
+#if defined(_WIN32)
+            if (mapped != nullptr) {
+                UnmapViewOfFile(mapped);
+            }
+            if (mappingHandle != nullptr) {
+                CloseHandle(mappingHandle);
+            }
+            if (fileHandle != INVALID_HANDLE_VALUE) {
+                CloseHandle(fileHandle);
+            }
+            mappingHandle = nullptr;
+            fileHandle = INVALID_HANDLE_VALUE;
+#else
+            if (mapped != nullptr) {
+                munmap(const_cast<char*>(mapped), length);
+            }
+#endif
+            mapped = nullptr;
+            length = 0;
+        }
+
+    public:
+        /*
+            @brief 构造函数，映射整个文件
+            @param path 文件路径
+            @param sequential 是否提示操作系统将按顺序读取（madvise MADV_SEQUENTIAL）
+            @throws runtime_error 如果文件无法打开或映射
+        */
+        explicit MappedFile(const std::string& path, bool sequential = false)
+        {
+#if defined(_WIN32)
+            fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (fileHandle == INVALID_HANDLE_VALUE) {
+                throw std::runtime_error("Failed to open file: " + path);
+            }
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(fileHandle, &fileSize)) {
+                release();
+                throw std::runtime_error("Failed to get file size: " + path);
+            }
+            length = static_cast<std::size_t>(fileSize.QuadPart);
+            if (length == 0) {
+                return;
+            }
+            mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mappingHandle == nullptr) {
+                release();
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+            mapped = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+            if (mapped == nullptr) {
+                release();
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to open file: " + path);
+            }
+            struct stat info;
+            if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+                ::close(fd);
+                throw std::runtime_error("Not a regular file: " + path);
+            }
+            length = static_cast<std::size_t>(info.st_size);
+            if (length > 0) {
+                void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address == MAP_FAILED) {
+                    ::close(fd);
+                    length = 0;
+                    throw std::runtime_error("Failed to map file: " + path);
+                }
+                mapped = static_cast<const char*>(address);
+                if (sequential) {
+                    madvise(address, length, MADV_SEQUENTIAL);
+                }
+            }
+            //映射建立后文件描述符不再需要
+            ::close(fd);
+#endif
+        }
+
+        /*
+            @brief 析构函数，解除映射
+        */
+        ~MappedFile()
+        {
+            release();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+        {
+            *this = std::move(other);
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other) {
+                release();
+                std::swap(mapped, other.mapped);
+                std::swap(length, other.length);
+#if defined(_WIN32)
+                std::swap(fileHandle, other.fileHandle);
+                std::swap(mappingHandle, other.mappingHandle);
+#endif
+            }
+            return *this;
+        }
+
+        /*
+            @brief 获取映射的起始地址，空文件返回nullptr
+        */
+        const char* data() const
+        {
+            return mapped;
+        }
+
+        /*
+            @brief 获取文件大小
+        */
+        std::size_t size() const
+        {
+            return length;
+        }
+
+        /*
+            @brief 以string_view形式访问文件内容
+        */
+        std::string_view view() const
+        {
+            return mapped == nullptr ? std::string_view() : std::string_view(mapped, length);
+        }
+    };
+}
@@ -0,0 +1,151 @@
+#include "MinHash.h"
+#include "PlagCheck.h"
+#include "Hashing.h"
+#include "Shingle.h"
+#include "Tokenizer.h"
+#include "Stats.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    /*
+        @brief 把32位随机数均匀映射到[0, k)，避免取模
+    */
+    static std::size_t fast_range(std::uint32_t value, std::size_t k) {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(value) * k) >> 32);
+    }
+
+    MinHashSignature compute_minhash(const std::vector<std::string_view>& words, std::size_t k, int ngram) {
+        if (k == 0) {
+            throw std::invalid_argument("MinHash signature size must be positive.");
+        }
+        if (ngram < 1 || ngram > ShingleRoller::maxSize) {
+            throw std::invalid_argument("shingle size must be in [1, 5].");
+        }
+        ScopedTimer timer(Phase::Hash);
+        if (words.empty()) {
+            return {};
+        }
+        MinHashSignature signature(k, std::numeric_limits<std::uint32_t>::max());
+        std::vector<bool> filled(k, false);
+        ShingleRoller roller(static_cast<int>(std::min<std::size_t>(ngram, words.size())));
+        std::uint64_t feature = 0;
+        for (const auto& word : words) {
+            if (!roller.push(string_hash(word), feature)) {
+                continue;
+            }
+            std::uint64_t mixed = mix64(feature);
+            std::size_t bin = fast_range(static_cast<std::uint32_t>(mixed >> 32), k);
+            std::uint32_t value = static_cast<std::uint32_t>(mixed);
+            if (!filled[bin] || value < signature[bin]) {
+                signature[bin] = value;
+                filled[bin] = true;
+            }
+        }
+
+        //最优致密化：空桶按 (桶号, 尝试次数) 决定的随机顺序借用非空桶的值
+        std::vector<std::uint32_t> original(signature);
+        for (std::size_t bin = 0; bin < k; ++bin) {
+            if (filled[bin]) {
+                continue;
+            }
+            for (std::uint64_t attempt = 1;; ++attempt) {
+                std::uint64_t probe = mix64((static_cast<std::uint64_t>(bin) << 32) ^ attempt);
+                std::size_t donor = fast_range(static_cast<std::uint32_t>(probe >> 32), k);
+                if (filled[donor]) {
+                    signature[bin] = original[donor];
+                    break;
+                }
+            }
+        }
+        return signature;
+    }
+
+    double minhash_similarity(const MinHashSignature& sig1, const MinHashSignature& sig2) {
+        if (sig1.empty() || sig1.size() != sig2.size()) {
+            return 0.0;
+        }
+        std::size_t equal = 0;
+        for (std::size_t i = 0; i < sig1.size(); ++i) {
+            equal += sig1[i] == sig2[i] ? 1 : 0;
+        }
+        return static_cast<double>(equal) / static_cast<double>(sig1.size());
+    }
+
+    double calcu_minhash_simi(std::string_view original, std::string_view copyed, int ngram) {
+        Tokenizer& tokenizer = Tokenizer::local();
+        std::vector<std::string_view> org_words;
+        std::vector<std::string_view> cop_words;
+        tokenizer.tokenize(original, org_words);
+        tokenizer.tokenize(copyed, cop_words);
+        if (org_words.empty() || cop_words.empty()) {
+            return 0.00;
+        }
+        return minhash_similarity(compute_minhash(org_words, 128, ngram), compute_minhash(cop_words, 128, ngram));
+    }
+
+    MinHashLSH::MinHashLSH(std::size_t bands, std::size_t rows)
+        : bands(bands), rows(rows), buckets(bands) {
+        if (bands == 0 || rows == 0) {
+            throw std::invalid_argument("MinHashLSH bands and rows must be positive.");
+        }
+    }
+
+    std::uint64_t MinHashLSH::band_key(const MinHashSignature& signature, std::size_t band) const {
+        std::uint64_t key = band;
+        for (std::size_t r = 0; r < rows; ++r) {
+            key = mix64(key ^ signature[band * rows + r]);
+        }
+        return key;
+    }
+
+    std::size_t MinHashLSH::add(const std::string& doc_id, const MinHashSignature& signature) {
+        if (signature.size() < bands * rows) {
+            throw std::invalid_argument("MinHash signature is shorter than bands * rows.");
+        }
+        std::uint32_t doc = static_cast<std::uint32_t>(docIds.size());
+        docIds.push_back(doc_id);
+        signatures.push_back(signature);
+        for (std::size_t band = 0; band < bands; ++band) {
+            buckets[band][band_key(signature, band)].push_back(doc);
+        }
+        return doc;
+    }
+
+    std::vector<MinHashLSH::Match> MinHashLSH::query(const MinHashSignature& signature, double threshold) const {
+        ScopedTimer timer(Phase::Compare);
+        std::vector<Match> matches;
+        if (signature.size() < bands * rows) {
+            return matches;
+        }
+        std::vector<std::uint32_t> candidates;
+        for (std::size_t band = 0; band < bands; ++band) {
+            auto it = buckets[band].find(band_key(signature, band));
+            if (it != buckets[band].end()) {
+                candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        for (std::uint32_t doc : candidates) {
+            double similarity = minhash_similarity(signature, signatures[doc]);
+            if (similarity >= threshold) {
+                matches.push_back({ doc, similarity });
+            }
+        }
+        std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+            return a.similarity != b.similarity ? a.similarity > b.similarity : a.doc < b.doc;
+        });
+        return matches;
+    }
+
+    const std::string& MinHashLSH::doc_id(std::size_t doc) const {
+        return docIds.at(doc);
+    }
+
+    std::size_t MinHashLSH::size() const {
+        return docIds.size();
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief MinHash签名，每个元素是一个桶中的最小哈希值
+    */
+    using MinHashSignature = std::vector<std::uint32_t>;
+
+    /*
+        @brief 计算单词（n-gram）集合的MinHash签名
+        @details 采用单次置换哈希（one-permutation hashing）：每个特征只哈希一次，
+                 高32位决定落入k个桶中的哪一个，低32位作为桶内比较的值；
+                 之后用最优致密化（optimal densification）为空桶借用其他桶的值，
+                 借用顺序只依赖桶号，保证不同文档之间可以比较。
+        @param words 输入的单词视图向量（与compute_simhash使用同一份分词结果）
+        @param k 签名长度（桶数）
+        @param ngram 以几个单词的n-gram为特征，取值[1, 5]
+        @return 返回长度为k的签名，空文档返回空签名
+        @throws invalid_argument 如果k为0或ngram不在[1, 5]之间
+    */
+    MinHashSignature compute_minhash(const std::vector<std::string_view>& words, std::size_t k = 128, int ngram = 1);
+
+    /*
+        @brief 由两个签名估计Jaccard相似度
+        @param sig1 第一个签名
+        @param sig2 第二个签名
+        @return 返回相同位置取值相同的比例，任一签名为空或长度不同时返回0
+    */
+    double minhash_similarity(const MinHashSignature& sig1, const MinHashSignature& sig2);
+
+    /*
+        @brief 使用MinHash估计两个字符串的Jaccard相似度
+        @param original 原文字符串
+        @param copyed 被查重文章的字符串
+        @param ngram 以几个单词的n-gram为特征，取值[1, 5]
+        @return 返回字符串的相似度
+    */
+    double calcu_minhash_simi(std::string_view original, std::string_view copyed, int ngram = 1);
+
+    /*
+        @brief MinHash的LSH分段索引
+        @details 把签名切成bands段、每段rows个值，任意一段完全相同的文档成为候选，
+                 再用minhash_similarity精确校验。Jaccard相似度为s的两篇文档成为候选的概率为
+                 1 - (1 - s^rows)^bands，默认32×4时阈值约为0.42。
+        @method add 添加一篇文档的签名
+        @method query 查询相似度不低于阈值的文档
+    */
+    class MinHashLSH {
+    public:
+        /*
+            @brief 一条查询结果
+            @param doc 文档在索引中的下标
+            @param similarity 估计的Jaccard相似度
+        */
+        struct Match {
+            std::size_t doc;
+            double similarity;
+        };
+
+        /*
+            @brief 构造函数
+            @param bands 段数
+            @param rows 每段的值个数
+            @throws invalid_argument 如果bands或rows为0
+        */
+        explicit MinHashLSH(std::size_t bands = 32, std::size_t rows = 4);
+
+        /*
+            @brief 添加一篇文档的签名
+            @param doc_id 文档标识（通常为文件路径）
+            @param signature 文档的MinHash签名，长度至少为 bands × rows
+            @return 返回文档在索引中的下标
+            @throws invalid_argument 如果签名长度不足
+        */
+        std::size_t add(const std::string& doc_id, const MinHashSignature& signature);
+
+        /*
+            @brief 查询相似度不低于阈值的文档
+            @param signature 查询的MinHash签名
+            @param threshold 相似度阈值
+            @return 返回按相似度降序排列的查询结果
+        */
+        std::vector<Match> query(const MinHashSignature& signature, double threshold) const;
+
+        /*
+            @brief 获取文档标识
+            @param doc 文档下标
+        */
+        const std::string& doc_id(std::size_t doc) const;
+
+        /*
+            @brief 获取索引中的文档数量
+        */
+        std::size_t size() const;
+
+    private:
+        std::size_t bands;
+        std::size_t rows;
+        std::vector<std::unordered_map<std::uint64_t, std::vector<std::uint32_t>>> buckets;
+        std::vector<std::string> docIds;
+        std::vector<MinHashSignature> signatures;
+
+        std::uint64_t band_key(const MinHashSignature& signature, std::size_t band) const;
+    };
+}
@@ -0,0 +1,146 @@
+#include "ParallelSimHash.h"
+#include "PlagCheck.h"
+#include "Shingle.h"
+#include "SimHashKernel.h"
+#include "TextBoundary.h"
+#include "Tokenizer.h"
+#include "Stats.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace PlagCheck {
+
+    /*
+        @brief 一个片段的边界信息，用于补算跨越片段的n-gram
+        @param words 片段中的单词数
+        @param head 片段开头至多n-1个单词的哈希
+        @param tail 片段结尾至多n-1个单词的哈希
+    */
+    struct PieceEdges {
+        std::uint64_t words = 0;
+        std::vector<std::uint64_t> head;
+        std::vector<std::uint64_t> tail;
+    };
+
+    std::bitset<64> compute_fingerprint_parallel(std::string_view content, int ngram, WorkStealingPool& pool,
+        std::size_t pieceSize, std::uint64_t* words) {
+        if (ngram < 1 || ngram > ShingleRoller::maxSize) {
+            throw std::invalid_argument("shingle size must be in [1, 5].");
+        }
+        std::size_t edge = static_cast<std::size_t>(ngram - 1);
+
+        //切分只做字节扫描，不涉及ICU
+        std::vector<std::string_view> pieces;
+        std::size_t start = 0;
+        while (start < content.size()) {
+            std::size_t end = content.size() - start <= pieceSize
+                ? content.size()
+                : next_safe_break(content, start + std::max<std::size_t>(pieceSize, 1));
+            pieces.push_back(content.substr(start, end - start));
+            start = end;
+        }
+
+        //每个工作线程一组计数器，最后一组留给池外线程
+        std::vector<SimHashAccumulator> accumulators(pool.size() + 1);
+        std::vector<PieceEdges> edges(pieces.size());
+        for (std::size_t p = 0; p < pieces.size(); ++p) {
+            pool.submit([&, p] {
+                int worker = WorkStealingPool::current_worker();
+                SimHashAccumulator& accumulator = accumulators[worker >= 0 ? worker : pool.size()];
+                thread_local std::vector<std::string_view> pieceWords;
+                Tokenizer::local().tokenize(pieces[p], pieceWords);
+
+                ScopedTimer timer(Phase::Hash);
+                if (Stats::enabled()) {
+                    Stats::add_hashes(pieceWords.size());
+                }
+                PieceEdges& piece = edges[p];
+                piece.words = pieceWords.size();
+                ShingleRoller roller(ngram);
+                std::uint64_t batch[256];
+                std::size_t filled = 0;
+                for (std::size_t i = 0; i < pieceWords.size(); ++i) {
+                    std::uint64_t hash = string_hash(pieceWords[i]);
+                    if (i < edge) {
+                        piece.head.push_back(hash);
+                    }
+                    if (i + edge >= pieceWords.size()) {
+                        piece.tail.push_back(hash);
+                    }
+                    if (!roller.push(hash, batch[filled])) {
+                        continue;
+                    }
+                    if (++filled == std::size(batch)) {
+                        accumulator.add(batch, filled);
+                        filled = 0;
+                    }
+                }
+                accumulator.add(batch, filled);
+            });
+        }
+        pool.wait();
+
+        SimHashAccumulator total;
+        for (const auto& accumulator : accumulators) {
+            total.merge(accumulator);
+        }
+
+        //按顺序补算跨越片段边界的n-gram：前文末尾至多n-1个单词接上本片段开头至多n-1个单词
+        std::uint64_t wordCount = 0;
+        std::vector<std::uint64_t> carry;
+        std::vector<std::uint64_t> all;
+        for (const auto& piece : edges) {
+            wordCount += piece.words;
+            if (edge == 0 || piece.words == 0) {
+                continue;
+            }
+            if (!carry.empty()) {
+                ShingleRoller roller(ngram);
+                std::uint64_t shingle = 0;
+                for (std::uint64_t hash : carry) {
+                    roller.push(hash, shingle);
+                }
+                for (std::uint64_t hash : piece.head) {
+                    if (roller.push(hash, shingle)) {
+                        total.add(shingle);
+                    }
+                }
+            }
+            if (all.size() < edge) {
+                all.insert(all.end(), piece.head.begin(), piece.head.end());
+            }
+            carry.insert(carry.end(), piece.tail.begin(), piece.tail.end());
+            if (carry.size() > edge) {
+                carry.erase(carry.begin(), carry.end() - edge);
+            }
+        }
+
+        //与compute_simhash一致：单词数不足n个时整个单词序列作为一个n-gram
+        if (wordCount > 0 && wordCount < static_cast<std::uint64_t>(ngram)) {
+            ShingleRoller shortRoller(static_cast<int>(wordCount));
+            std::uint64_t shingle = 0;
+            for (std::uint64_t i = 0; i < wordCount; ++i) {
+                if (shortRoller.push(all[i], shingle)) {
+                    total.add(shingle);
+                }
+            }
+        }
+        if (words != nullptr) {
+            *words = wordCount;
+        }
+        return total.fingerprint();
+    }
+
+    double calcu_simi_parallel(std::string_view original, std::string_view copyed, WorkStealingPool& pool, int ngram) {
+        std::uint64_t orgWords = 0;
+        std::uint64_t copyWords = 0;
+        std::bitset<64> hash1 = compute_fingerprint_parallel(original, ngram, pool, 4 * 1024 * 1024, &orgWords);
+        std::bitset<64> hash2 = compute_fingerprint_parallel(copyed, ngram, pool, 4 * 1024 * 1024, &copyWords);
+        if (orgWords == 0 || copyWords == 0) {
+            return 0.00;
+        }
+        ScopedTimer timer(Phase::Compare);
+        return similarity_from_distance(hamming_distance(hash1, hash2));
+    }
+}
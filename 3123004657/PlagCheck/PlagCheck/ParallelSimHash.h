@@ -0,0 +1,35 @@
+#pragma once
+#include "WorkStealingPool.hpp"
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace PlagCheck {
+    /*
+        @brief 多线程计算单篇大文档的SimHash值
+        @details 先逐字节扫描，把文本在空白或句末标点等安全切分点处切成约pieceSize字节的片段，
+                 各片段独立分词、哈希并累加到所在工作线程自己的64个计数器上，最后把计数器相加。
+                 n-gram大于1时，跨越片段边界的n-gram由相邻片段首尾的n-1个单词哈希补算，
+                 因此结果与 compute_fingerprint 的顺序计算完全相同。
+        @param content 文档内容
+        @param ngram n-gram中的单词数，取值[1, 5]
+        @param pool 执行任务的线程池
+        @param pieceSize 每个片段的目标字节数
+        @param words 不为nullptr时写入单词数
+        @return 返回文档的SimHash值
+        @throws invalid_argument 如果ngram不在[1, 5]之间
+    */
+    std::bitset<64> compute_fingerprint_parallel(std::string_view content, int ngram, WorkStealingPool& pool,
+        std::size_t pieceSize = 4 * 1024 * 1024, std::uint64_t* words = nullptr);
+
+    /*
+        @brief 多线程计算两篇文档的相似度，结果与 calcu_simi 相同
+        @param original 原文内容
+        @param copyed 抄袭版内容
+        @param pool 执行任务的线程池
+        @param ngram n-gram中的单词数，取值[1, 5]
+        @return 返回相似度，取值[0, 1]
+    */
+    double calcu_simi_parallel(std::string_view original, std::string_view copyed, WorkStealingPool& pool, int ngram = 1);
+}
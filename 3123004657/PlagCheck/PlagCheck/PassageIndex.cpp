@@ -0,0 +1,200 @@
+#include "PassageIndex.h"
+#include "Shingle.h"
+#include "Stats.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace PlagCheck {
+
+    /*
+        @brief 以LEB128变长格式追加一个无符号整数
+    */
+    static void put_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    /*
+        @brief 读取一个LEB128变长整数并前移读取位置
+    */
+    static std::uint64_t get_varint(const std::uint8_t*& cursor) {
+        std::uint64_t value = 0;
+        int shift = 0;
+        while (*cursor & 0x80) {
+            value |= static_cast<std::uint64_t>(*cursor++ & 0x7F) << shift;
+            shift += 7;
+        }
+        value |= static_cast<std::uint64_t>(*cursor++) << shift;
+        return value;
+    }
+
+    PassageIndex::PassageIndex(int k, int window)
+        : k(k), window(window) {
+        ShingleRoller check(k);
+        if (window < 1) {
+            throw std::invalid_argument("winnowing window must be at least 1.");
+        }
+        offsets.push_back(0);
+    }
+
+    std::size_t PassageIndex::add(const std::string& doc_id, std::string_view content) {
+        if (docIds.size() >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("PassageIndex is full.");
+        }
+        std::uint32_t doc = static_cast<std::uint32_t>(docIds.size());
+        docIds.push_back(doc_id);
+        for (const auto& fp : winnow(content, k, window)) {
+            pending.push_back(Entry{ fp.hash, Posting{ doc, fp.begin, fp.end } });
+        }
+        built = false;
+        return doc;
+    }
+
+    void PassageIndex::build() {
+        if (pending.empty()) {
+            built = true;
+            return;
+        }
+        //已压缩的倒排表解码后与新记录一起重新编码
+        std::vector<Posting> decoded;
+        for (std::size_t slot = 0; slot < hashes.size(); ++slot) {
+            decoded.clear();
+            decode(slot, decoded, std::numeric_limits<std::size_t>::max());
+            for (const auto& posting : decoded) {
+                pending.push_back(Entry{ hashes[slot], posting });
+            }
+        }
+        std::sort(pending.begin(), pending.end(), [](const Entry& a, const Entry& b) {
+            if (a.hash != b.hash) {
+                return a.hash < b.hash;
+            }
+            if (a.posting.doc != b.posting.doc) {
+                return a.posting.doc < b.posting.doc;
+            }
+            return a.posting.begin < b.posting.begin;
+        });
+
+        hashes.clear();
+        offsets.assign(1, 0);
+        bytes.clear();
+        std::size_t i = 0;
+        while (i < pending.size()) {
+            std::size_t j = i;
+            while (j < pending.size() && pending[j].hash == pending[i].hash) {
+                ++j;
+            }
+            //倒排表格式：记录数 | (文档号差值, 起始偏移差值或绝对值, 长度) × 记录数
+            hashes.push_back(pending[i].hash);
+            put_varint(bytes, j - i);
+            std::uint32_t lastDoc = 0;
+            std::uint32_t lastBegin = 0;
+            for (std::size_t e = i; e < j; ++e) {
+                const Posting& posting = pending[e].posting;
+                put_varint(bytes, posting.doc - lastDoc);
+                put_varint(bytes, posting.doc == lastDoc ? posting.begin - lastBegin : posting.begin);
+                put_varint(bytes, posting.end - posting.begin);
+                lastDoc = posting.doc;
+                lastBegin = posting.begin;
+            }
+            offsets.push_back(bytes.size());
+            i = j;
+        }
+        pending.clear();
+        pending.shrink_to_fit();
+        bytes.shrink_to_fit();
+        built = true;
+    }
+
+    std::size_t PassageIndex::find(std::uint64_t hash) const {
+        auto it = std::lower_bound(hashes.begin(), hashes.end(), hash);
+        if (it == hashes.end() || *it != hash) {
+            return hashes.size();
+        }
+        return static_cast<std::size_t>(it - hashes.begin());
+    }
+
+    std::uint64_t PassageIndex::decode(std::size_t slot, std::vector<Posting>& out, std::size_t limit) const {
+        const std::uint8_t* cursor = bytes.data() + offsets[slot];
+        std::uint64_t count = get_varint(cursor);
+        if (count > limit) {
+            return count;
+        }
+        std::uint32_t doc = 0;
+        std::uint32_t begin = 0;
+        for (std::uint64_t n = 0; n < count; ++n) {
+            std::uint32_t docDelta = static_cast<std::uint32_t>(get_varint(cursor));
+            std::uint32_t beginValue = static_cast<std::uint32_t>(get_varint(cursor));
+            std::uint32_t length = static_cast<std::uint32_t>(get_varint(cursor));
+            //编码时以(文档0, 偏移0)为初值，第一条记录也按同样的差值规则解码
+            begin = docDelta == 0 ? begin + beginValue : beginValue;
+            doc += docDelta;
+            out.push_back(Posting{ doc, begin, begin + length });
+        }
+        return count;
+    }
+
+    std::vector<PassageIndex::Posting> PassageIndex::postings(std::uint64_t hash) const {
+        std::vector<Posting> out;
+        std::size_t slot = find(hash);
+        if (slot < hashes.size()) {
+            decode(slot, out, std::numeric_limits<std::size_t>::max());
+        }
+        return out;
+    }
+
+    std::vector<PassageIndex::DocumentMatch> PassageIndex::locate(std::string_view content, std::size_t maxPostings) const {
+        if (!built) {
+            throw std::logic_error("PassageIndex::build must be called before locate.");
+        }
+        //按文档收集指纹命中
+        std::unordered_map<std::uint32_t, std::vector<Passage>> hits;
+        std::vector<Posting> decoded;
+        for (const auto& fp : winnow(content, k, window)) {
+            std::size_t slot = find(fp.hash);
+            if (slot == hashes.size()) {
+                continue;
+            }
+            decoded.clear();
+            decode(slot, decoded, maxPostings);
+            for (const auto& posting : decoded) {
+                hits[posting.doc].push_back(Passage{ fp.begin, fp.end, posting.begin, posting.end, 1 });
+            }
+        }
+
+        ScopedTimer timer(Phase::Compare);
+        std::vector<DocumentMatch> matches;
+        matches.reserve(hits.size());
+        for (auto& [doc, docHits] : hits) {
+            DocumentMatch match;
+            match.doc = doc;
+            match.passages = merge_passages(std::move(docHits));
+            match.coveredBytes = covered_bytes(match.passages);
+            matches.push_back(std::move(match));
+        }
+        std::sort(matches.begin(), matches.end(), [](const DocumentMatch& a, const DocumentMatch& b) {
+            return a.coveredBytes != b.coveredBytes ? a.coveredBytes > b.coveredBytes : a.doc < b.doc;
+        });
+        return matches;
+    }
+
+    const std::string& PassageIndex::doc_id(std::size_t doc) const {
+        return docIds.at(doc);
+    }
+
+    std::size_t PassageIndex::size() const {
+        return docIds.size();
+    }
+
+    std::size_t PassageIndex::fingerprint_count() const {
+        return hashes.size();
+    }
+
+    std::size_t PassageIndex::posting_bytes() const {
+        return bytes.size();
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "Winnowing.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief winnowing指纹的倒排索引，用于在语料库中定位抄袭段落
+        @details 每个指纹对应一条记录(文档, 起始偏移, 结束偏移)的倒排表。build时把倒排表压缩为
+                 变长整数编码的字节流：文档号按差值存储，同一文档内的起始偏移也按差值存储，
+                 结束偏移存为长度，一条记录通常只占3～5个字节，百万级文档的语料库也能放入内存。
+                 指纹本身只保存一份有序数组，查询时二分查找后顺序解码对应的倒排表。
+        @method add 添加一篇文档
+        @method build 压缩倒排表，查询前必须调用
+        @method locate 定位待查文档与语料库中每篇文档的匹配段落
+        @method postings 解码一个指纹的倒排表
+    */
+    class PassageIndex {
+    public:
+        /*
+            @brief 倒排表中的一条记录
+            @param doc 文档在索引中的下标
+            @param begin 指纹k-gram的起始字节偏移
+            @param end 指纹k-gram的结束字节偏移
+        */
+        struct Posting {
+            std::uint32_t doc;
+            std::uint32_t begin;
+            std::uint32_t end;
+        };
+
+        /*
+            @brief 一篇与待查文档存在匹配段落的文档
+            @param doc 文档在索引中的下标
+            @param passages 按待查文档位置排序的匹配段落
+            @param coveredBytes 匹配段落在待查文档中覆盖的字节数
+        */
+        struct DocumentMatch {
+            std::size_t doc;
+            std::vector<Passage> passages;
+            std::uint64_t coveredBytes;
+        };
+
+        /*
+            @brief 构造函数
+            @param k k-gram中的单词数，范围[1, 5]
+            @param window winnowing窗口大小
+            @throws invalid_argument 如果k或window不合法
+        */
+        explicit PassageIndex(int k = 5, int window = 4);
+
+        /*
+            @brief 对文档做winnowing并加入索引
+            @param doc_id 文档标识（通常为文件路径）
+            @param content 文档内容
+            @return 返回文档在索引中的下标
+        */
+        std::size_t add(const std::string& doc_id, std::string_view content);
+
+        /*
+            @brief 把新加入的指纹合并进压缩的倒排表，添加完文档后、查询前调用
+        */
+        void build();
+
+        /*
+            @brief 定位待查文档与语料库中各文档的匹配段落
+            @param content 待查文档内容
+            @param maxPostings 倒排表长度超过该值的指纹视为模板化的常见内容，不参与定位
+            @return 返回按覆盖字节数降序排列的文档
+            @throws logic_error 如果索引尚未build
+        */
+        std::vector<DocumentMatch> locate(std::string_view content, std::size_t maxPostings = 1000) const;
+
+        /*
+            @brief 解码一个指纹的倒排表
+            @param hash 指纹的哈希值
+            @return 返回按文档和位置排序的记录，指纹不存在时为空
+        */
+        std::vector<Posting> postings(std::uint64_t hash) const;
+
+        /*
+            @brief 获取文档标识
+            @param doc 文档下标
+        */
+        const std::string& doc_id(std::size_t doc) const;
+
+        /*
+            @brief 获取索引中的文档数量
+        */
+        std::size_t size() const;
+
+        /*
+            @brief 获取不同指纹的数量
+        */
+        std::size_t fingerprint_count() const;
+
+        /*
+            @brief 获取压缩后倒排表占用的字节数
+        */
+        std::size_t posting_bytes() const;
+
+    private:
+        /*
+            @brief 尚未压缩的指纹记录
+        */
+        struct Entry {
+            std::uint64_t hash;
+            Posting posting;
+        };
+
+        int k;
+        int window;
+        bool built = true;
+        std::vector<std::string> docIds;
+        std::vector<Entry> pending;
+        std::vector<std::uint64_t> hashes;
+        std::vector<std::uint64_t> offsets;
+        std::vector<std::uint8_t> bytes;
+
+        std::size_t find(std::uint64_t hash) const;
+        std::uint64_t decode(std::size_t slot, std::vector<Posting>& out, std::size_t limit) const;
+    };
+}
@@ -1,103 +1,142 @@
 #include "PlagCheck.h"
-#include <unicode/brkiter.h>
-#include <unicode/ustring.h>
-#include <unicode/utext.h>
+#include "Tokenizer.h"
+#include "SimHashKernel.h"
+#include "Shingle.h"
+#include "Hashing.h"
+#include "Stats.h"
 #include <sstream>
 #include <functional>
 #include <regex>
-#include <iostream>
+#include <stdexcept>
+#include <algorithm>
 
 namespace PlagCheck {
 
-    std::vector<std::string> split_into_words(std::string content) {
-        if (content.empty()) {
-            return {};
-        }
-        UErrorCode status = U_ZERO_ERROR;
-        UText* ut = utext_openUTF8(NULL, content.c_str(), content.length(), &status);
-        if (U_FAILURE(status)) {
-            return {};
-        }
-        icu::BreakIterator* bi = icu::BreakIterator::createWordInstance(
-            icu::Locale::getChinese(), status);
-        if (U_FAILURE(status)) {
-            utext_close(ut);
-            return {};
-        }
-        bi->setText(ut, status);
-        if (U_FAILURE(status)) {
-            delete bi;
-            utext_close(ut);
-            return {};
-        }
-        std::vector<std::string> words;
-        int32_t start = bi->first();
-        int32_t end = bi->next();
-        while (end != icu::BreakIterator::DONE) {
-            int32_t length = end - start;
-            if (length > 0) {
-                std::string word = content.substr(start, length);
-                bool is_punctuation = true;
-                for (char c : word) {
-                    if (!std::ispunct(static_cast<unsigned char>(c)) &&
-                        !std::isspace(static_cast<unsigned char>(c))) {
-                        is_punctuation = false;
-                        break;
-                    }
-                }
-                if (!is_punctuation) {
-                    words.push_back(word);
-                }
-            }
-            start = end;
-            end = bi->next();
-        }
-        delete bi;
-        utext_close(ut);
-        std::cout << "Total words extracted: " << words.size() << std::endl;
-        return words;
+    std::vector<std::string> split_into_words(const std::string& content) {
+        std::vector<std::string_view> views;
+        Tokenizer::local().tokenize(content, views);
+        return std::vector<std::string>(views.begin(), views.end());
     }
 
-    std::size_t string_hash(const std::string& str) {
-        return std::hash<std::string>{}(str);
+    std::uint64_t string_hash(const std::string& str) {
+        return xxhash64(str);
     }
 
-    std::bitset<64> compute_simhash(const std::vector<std::string>& words) {
-        std::vector<int> hash_vector(64, 0);
+    std::uint64_t string_hash(std::string_view str) {
+        return xxhash64(str);
+    }
+
+    /*
+        @brief compute_simhash 的公共实现，适用于 std::string 与 std::string_view 序列
+    */
+    template <typename Word, std::size_t Bits>
+    static void accumulate_words(const std::vector<Word>& words, int ngram, BasicSimHashAccumulator<Bits>& accumulator) {
+        if (ngram < 1 || ngram > ShingleRoller::maxSize) {
+            throw std::invalid_argument("shingle size must be in [1, 5].");
+        }
+        ScopedTimer timer(Phase::Hash);
+        if (Stats::enabled()) {
+            Stats::add_hashes(words.size());
+        }
+        //单词数不足n个时，整个单词序列作为一个n-gram
+        ShingleRoller roller(static_cast<int>(std::min<std::size_t>(ngram, std::max<std::size_t>(words.size(), 1))));
+        //分批哈希后交给向量化内核累加
+        std::uint64_t batch[256];
+        std::size_t filled = 0;
         for (const auto& word : words) {
-            std::size_t hash_val = string_hash(word);
-            for (int i = 0; i < 64; ++i) {
-                if (hash_val & (1ULL << i)) {
-                    hash_vector[i] += 1;
-                }
-                else {
-                    hash_vector[i] -= 1;
-                }
+            if (!roller.push(string_hash(word), batch[filled])) {
+                continue;
             }
-        }
-        std::bitset<64> simhash;
-        for (int i = 0; i < 64; ++i) {
-            if (hash_vector[i] > 0) {
-                simhash.set(i);
+            if (++filled == std::size(batch)) {
+                accumulator.add(batch, filled);
+                filled = 0;
             }
         }
-        return simhash;
+        accumulator.add(batch, filled);
     }
 
-    int hamming_distance(const std::bitset<64>& hash1, const std::bitset<64>& hash2) {
-        return (hash1 ^ hash2).count();
+    template <std::size_t Bits>
+    void accumulate_simhash(const std::vector<std::string_view>& words, int ngram, BasicSimHashAccumulator<Bits>& accumulator) {
+        accumulate_words(words, ngram, accumulator);
     }
 
-    double calcu_simi(const std::string& original, const std::string& copyed) {
-        auto org_words = split_into_words(original);
-        auto cop_words = split_into_words(copyed);
+    template <std::size_t Bits>
+    std::bitset<Bits> compute_simhash(const std::vector<std::string_view>& words, int ngram) {
+        BasicSimHashAccumulator<Bits> accumulator;
+        accumulate_words(words, ngram, accumulator);
+        return accumulator.fingerprint();
+    }
+
+    template <std::size_t Bits>
+    std::bitset<Bits> compute_fingerprint(std::string_view content, int ngram) {
+        thread_local std::vector<std::string_view> words;
+        Tokenizer::local().tokenize(content, words);
+        return compute_simhash<Bits>(words, ngram);
+    }
+
+    template <std::size_t Bits>
+    double calcu_simi(std::string_view original, std::string_view copyed, int ngram) {
+        Tokenizer& tokenizer = Tokenizer::local();
+        std::vector<std::string_view> org_words;
+        std::vector<std::string_view> cop_words;
+        tokenizer.tokenize(original, org_words);
+        tokenizer.tokenize(copyed, cop_words);
         if (org_words.empty() || cop_words.empty()) {
             return 0.00;
         }
-        std::bitset<64> hash1 = compute_simhash(org_words);
-        std::bitset<64> hash2 = compute_simhash(cop_words);
-        int distance = hamming_distance(hash1, hash2);
-        double similarity = 1.0 - (static_cast<double>(distance) / 64.0);
-        return std::max(0.0, similarity);
+        std::bitset<Bits> hash1 = compute_simhash<Bits>(org_words, ngram);
+        std::bitset<Bits> hash2 = compute_simhash<Bits>(cop_words, ngram);
+        ScopedTimer timer(Phase::Compare);
+        return similarity_from_distance<Bits>(hamming_distance(hash1, hash2));
+    }
+
+    //64位的非模板版本只转发到对应的模板，只保留一份实现
+    void accumulate_simhash(const std::vector<std::string_view>& words, int ngram, SimHashAccumulator& accumulator) {
+        accumulate_simhash<64>(words, ngram, accumulator);
+    }
+
+    std::bitset<64> compute_simhash(const std::vector<std::string>& words) {
+        //std::string序列没有对应的模板版本，直接使用公共实现
+        SimHashAccumulator accumulator;
+        accumulate_words(words, 1, accumulator);
+        return accumulator.fingerprint();
+    }
+
+    std::bitset<64> compute_simhash(const std::vector<std::string_view>& words) {
+        return compute_simhash<64>(words, 1);
+    }
+
+    std::bitset<64> compute_simhash(const std::vector<std::string_view>& words, int ngram) {
+        return compute_simhash<64>(words, ngram);
+    }
+
+    std::bitset<64> compute_fingerprint(std::string_view content, int ngram) {
+        return compute_fingerprint<64>(content, ngram);
     }
+
+    int hamming_distance(const std::bitset<64>& hash1, const std::bitset<64>& hash2) {
+        return hamming_distance<64>(hash1, hash2);
+    }
+
+    double similarity_from_distance(int distance) {
+        return similarity_from_distance<64>(distance);
+    }
+
+    double calcu_simi(std::string_view original, std::string_view copyed, int ngram) {
+        return calcu_simi<64>(original, copyed, ngram);
+    }
+
+    //支持的指纹宽度，每种宽度生成各自的累加与popcount代码
+    template std::bitset<64> compute_simhash<64>(const std::vector<std::string_view>&, int);
+    template std::bitset<128> compute_simhash<128>(const std::vector<std::string_view>&, int);
+    template std::bitset<256> compute_simhash<256>(const std::vector<std::string_view>&, int);
+    template void accumulate_simhash<64>(const std::vector<std::string_view>&, int, BasicSimHashAccumulator<64>&);
+    template void accumulate_simhash<128>(const std::vector<std::string_view>&, int, BasicSimHashAccumulator<128>&);
+    template void accumulate_simhash<256>(const std::vector<std::string_view>&, int, BasicSimHashAccumulator<256>&);
+    template std::bitset<64> compute_fingerprint<64>(std::string_view, int);
+    template std::bitset<128> compute_fingerprint<128>(std::string_view, int);
+    template std::bitset<256> compute_fingerprint<256>(std::string_view, int);
+    template double calcu_simi<64>(std::string_view, std::string_view, int);
+    template double calcu_simi<128>(std::string_view, std::string_view, int);
+    template double calcu_simi<256>(std::string_view, std::string_view, int);
 }
\ No newline at end of file
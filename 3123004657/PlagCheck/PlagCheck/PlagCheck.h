@@ -2,8 +2,12 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <bitset>
+#include <bit>
+#include <cstdint>
+#include "SimHashKernel.h"
 
 namespace PlagCheck {
     /*
@@ -11,14 +15,22 @@ namespace PlagCheck {
         @param content 输入的字符串内容
         @return 返回包含单词的字符串向量
     */
-    std::vector<std::string> split_into_words(std::string content);
+    std::vector<std::string> split_into_words(const std::string& content);
 
     /*
         @brief 计算字符串的哈希值
+        @details 使用种子为0的xxHash64，不同平台、不同编译器得到的哈希值相同
         @param str 输入的字符串
         @return 返回字符串的哈希值
     */
-    std::size_t string_hash(const std::string& str);
+    std::uint64_t string_hash(const std::string& str);
+
+    /*
+        @brief 计算字符串视图的哈希值，与同内容std::string的哈希值相同
+        @param str 输入的字符串视图
+        @return 返回字符串的哈希值
+    */
+    std::uint64_t string_hash(std::string_view str);
 
     /*
         @brief 计算字符串的SimHash值
@@ -27,6 +39,72 @@ namespace PlagCheck {
     */
     std::bitset<64> compute_simhash(const std::vector<std::string>& words);
 
+    /*
+        @brief 计算单词视图序列的SimHash值，结果与同内容的std::string版本相同
+        @param words 输入的单词视图向量
+        @return 返回字符串的SimHash值
+    */
+    std::bitset<64> compute_simhash(const std::vector<std::string_view>& words);
+
+    /*
+        @brief 以单词n-gram为特征计算SimHash值
+        @param words 输入的单词视图向量
+        @param ngram n-gram中的单词数，取值[1, 5]，为1时与不带该参数的版本相同
+        @return 返回字符串的SimHash值
+        @throws invalid_argument 如果ngram不在[1, 5]之间
+    */
+    std::bitset<64> compute_simhash(const std::vector<std::string_view>& words, int ngram);
+
+    /*
+        @brief 把单词（n-gram）哈希累加到SimHash累加器中
+        @details 与compute_simhash使用相同的特征，accumulator.fingerprint() 即为 compute_simhash 的结果
+        @param words 输入的单词视图向量
+        @param ngram n-gram中的单词数，取值[1, 5]
+        @param accumulator 累加目标
+        @throws invalid_argument 如果ngram不在[1, 5]之间
+    */
+    void accumulate_simhash(const std::vector<std::string_view>& words, int ngram, SimHashAccumulator& accumulator);
+
+    /*
+        @brief 以单词n-gram为特征计算Bits位的SimHash值
+        @details 每个特征只哈希一次，再由 simhash_lane 派生 Bits / 64 条通道；
+                 不带模板参数的64位版本直接转发到 compute_simhash<64>，两者只有一份实现。
+                 在PlagCheck.cpp中为64、128、256位显式实例化。
+        @param words 输入的单词视图向量
+        @param ngram n-gram中的单词数，取值[1, 5]
+        @return 返回字符串的SimHash值
+        @throws invalid_argument 如果ngram不在[1, 5]之间
+    */
+    template <std::size_t Bits>
+    std::bitset<Bits> compute_simhash(const std::vector<std::string_view>& words, int ngram);
+
+    /*
+        @brief 把单词（n-gram）哈希累加到Bits位的SimHash累加器中
+        @param words 输入的单词视图向量
+        @param ngram n-gram中的单词数，取值[1, 5]
+        @param accumulator 累加目标
+        @throws invalid_argument 如果ngram不在[1, 5]之间
+    */
+    template <std::size_t Bits>
+    void accumulate_simhash(const std::vector<std::string_view>& words, int ngram, BasicSimHashAccumulator<Bits>& accumulator);
+
+    /*
+        @brief 使用当前线程的Tokenizer对文本分词并计算SimHash值
+        @param content 输入的文本
+        @param ngram n-gram中的单词数，取值[1, 5]
+        @return 返回文本的SimHash值
+    */
+    std::bitset<64> compute_fingerprint(std::string_view content, int ngram = 1);
+
+    /*
+        @brief 使用当前线程的Tokenizer对文本分词并计算Bits位的SimHash值
+        @param content 输入的文本
+        @param ngram n-gram中的单词数，取值[1, 5]
+        @return 返回文本的SimHash值
+    */
+    template <std::size_t Bits>
+    std::bitset<Bits> compute_fingerprint(std::string_view content, int ngram = 1);
+
     /*
         @brief 计算两个SimHash值之间的汉明距离
         @param hash1 第一个SimHash值
@@ -35,11 +113,59 @@ namespace PlagCheck {
     */
     int hamming_distance(const std::bitset<64>& hash1, const std::bitset<64>& hash2);
 
+    /*
+        @brief 计算两个Bits位SimHash值之间的汉明距离
+        @details 64位时直接对整数做popcount；更宽的指纹由bitset逐个机器字popcount
+        @param hash1 第一个SimHash值
+        @param hash2 第二个SimHash值
+        @return 返回两个SimHash值之间的汉明距离，取值[0, Bits]
+    */
+    template <std::size_t Bits>
+    int hamming_distance(const std::bitset<Bits>& hash1, const std::bitset<Bits>& hash2)
+    {
+        if constexpr (Bits == 64) {
+            return std::popcount(hash1.to_ullong() ^ hash2.to_ullong());
+        }
+        else {
+            return static_cast<int>((hash1 ^ hash2).count());
+        }
+    }
+
+    /*
+        @brief 将汉明距离换算为相似度
+        @param distance 两个SimHash值之间的汉明距离
+        @return 返回[0, 1]之间的相似度
+    */
+    double similarity_from_distance(int distance);
+
+    /*
+        @brief 将Bits位指纹的汉明距离换算为相似度，每一位对应 1 / Bits 的相似度
+        @param distance 两个SimHash值之间的汉明距离
+        @return 返回[0, 1]之间的相似度
+    */
+    template <std::size_t Bits>
+    double similarity_from_distance(int distance)
+    {
+        double similarity = 1.0 - (static_cast<double>(distance) / static_cast<double>(Bits));
+        return similarity < 0.0 ? 0.0 : similarity;
+    }
+
     /*
         @brief 计算两个字符串的相似度
         @param original 原文字符串
         @param copyed 被查重文章的字符串
+        @param ngram 以几个单词的n-gram为特征，取值[1, 5]
+        @return 返回字符串的相似度
+    */
+    double calcu_simi(std::string_view original, std::string_view copyed, int ngram = 1);
+
+    /*
+        @brief 用Bits位SimHash计算两个字符串的相似度，相似度的分辨率为 1 / Bits
+        @param original 原文字符串
+        @param copyed 被查重文章的字符串
+        @param ngram 以几个单词的n-gram为特征，取值[1, 5]
         @return 返回字符串的相似度
     */
-    double calcu_simi(const std::string& original, const std::string& copyed);
+    template <std::size_t Bits>
+    double calcu_simi(std::string_view original, std::string_view copyed, int ngram = 1);
 }
\ No newline at end of file
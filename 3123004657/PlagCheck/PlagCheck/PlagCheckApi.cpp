@@ -0,0 +1,135 @@
+#include "PlagCheckApi.h"
+#include "PlagCheckContext.h"
+#include "PlagCheck.h"
+#include <exception>
+#include <string>
+
+//C接口的上下文就是C++的PlagCheckContext
+struct plagcheck_context {
+    PlagCheck::PlagCheckContext context;
+
+    explicit plagcheck_context(const PlagCheck::ContextOptions& options)
+        : context(options) {
+    }
+};
+
+//异常不能穿过C接口，转为错误码并记录在线程局部的错误信息中
+static thread_local std::string lastError;
+
+static int fail(const char* message) {
+    lastError = message;
+    return PLAGCHECK_ERROR;
+}
+
+extern "C" {
+
+    int plagcheck_abi_version(void) {
+        return PLAGCHECK_ABI_VERSION;
+    }
+
+    void plagcheck_options_init(plagcheck_options* options) {
+        if (options == nullptr) {
+            return;
+        }
+        options->ngram = 1;
+        options->tokenizer = PLAGCHECK_TOKENIZER_FAST;
+        options->dictionary_path = nullptr;
+        options->cache_path = nullptr;
+    }
+
+    plagcheck_context* plagcheck_context_create(const plagcheck_options* options) {
+        plagcheck_options defaults;
+        plagcheck_options_init(&defaults);
+        if (options == nullptr) {
+            options = &defaults;
+        }
+        PlagCheck::ContextOptions settings;
+        settings.ngram = options->ngram;
+        switch (options->tokenizer) {
+        case PLAGCHECK_TOKENIZER_FAST:
+            settings.engine = PlagCheck::TokenizerEngine::AsciiFast;
+            break;
+        case PLAGCHECK_TOKENIZER_ICU:
+            settings.engine = PlagCheck::TokenizerEngine::Icu;
+            break;
+        case PLAGCHECK_TOKENIZER_DICT:
+            settings.engine = PlagCheck::TokenizerEngine::Dictionary;
+            break;
+        default:
+            fail("unknown tokenizer.");
+            return nullptr;
+        }
+        settings.dictionaryPath = options->dictionary_path != nullptr ? options->dictionary_path : "";
+        settings.cachePath = options->cache_path != nullptr ? options->cache_path : "";
+        try {
+            return new plagcheck_context(settings);
+        }
+        catch (const std::exception& e) {
+            fail(e.what());
+            return nullptr;
+        }
+    }
+
+    void plagcheck_context_destroy(plagcheck_context* context) {
+        delete context;
+    }
+
+    int plagcheck_fingerprint(plagcheck_context* context, const char* text, size_t length,
+        uint64_t* fingerprint, uint64_t* words) {
+        if (context == nullptr || fingerprint == nullptr || (text == nullptr && length != 0)) {
+            return fail("invalid argument.");
+        }
+        try {
+            std::uint64_t wordCount = 0;
+            *fingerprint = context->context.fingerprint(std::string_view(text, length), &wordCount).to_ullong();
+            if (words != nullptr) {
+                *words = wordCount;
+            }
+            return PLAGCHECK_OK;
+        }
+        catch (const std::exception& e) {
+            return fail(e.what());
+        }
+    }
+
+    int plagcheck_distance(uint64_t fingerprint1, uint64_t fingerprint2) {
+        return PlagCheck::hamming_distance(std::bitset<64>(fingerprint1), std::bitset<64>(fingerprint2));
+    }
+
+    double plagcheck_compare(uint64_t fingerprint1, uint64_t fingerprint2) {
+        return PlagCheck::PlagCheckContext::compare(std::bitset<64>(fingerprint1), std::bitset<64>(fingerprint2));
+    }
+
+    int plagcheck_similarity(plagcheck_context* context, const char* original, size_t original_length,
+        const char* copyed, size_t copyed_length, double* similarity) {
+        if (context == nullptr || similarity == nullptr ||
+            (original == nullptr && original_length != 0) || (copyed == nullptr && copyed_length != 0)) {
+            return fail("invalid argument.");
+        }
+        try {
+            *similarity = context->context.similarity(std::string_view(original, original_length),
+                std::string_view(copyed, copyed_length));
+            return PLAGCHECK_OK;
+        }
+        catch (const std::exception& e) {
+            return fail(e.what());
+        }
+    }
+
+    int plagcheck_save_cache(plagcheck_context* context) {
+        if (context == nullptr) {
+            return fail("invalid argument.");
+        }
+        try {
+            context->context.save_cache();
+            return PLAGCHECK_OK;
+        }
+        catch (const std::exception& e) {
+            return fail(e.what());
+        }
+    }
+
+    const char* plagcheck_last_error(void) {
+        return lastError.c_str();
+    }
+}
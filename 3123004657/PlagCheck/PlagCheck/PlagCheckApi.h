@@ -0,0 +1,134 @@
+#pragma once
+/*
+    @brief libplagcheck的C接口
+    @details 只使用C类型，供Python（ctypes/cffi）、Java（JNA/Panama）等运行时直接链接，无需启动进程或进程间通信。
+             指纹以64位无符号整数传递，第i位即SimHash的第i位，与指纹文件中保存的值相同。
+             返回int的函数成功时返回 PLAGCHECK_OK，失败时返回 PLAGCHECK_ERROR，
+             错误信息由 plagcheck_last_error 取得。
+             一个上下文同一时刻只能由一个线程使用，不同线程应各自创建上下文。
+             作为动态库使用时，调用方应定义 PLAGCHECK_SHARED；构建动态库时另外定义 PLAGCHECK_BUILDING。
+*/
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(PLAGCHECK_SHARED)
+#if defined(_WIN32)
+#if defined(PLAGCHECK_BUILDING)
+#define PLAGCHECK_API __declspec(dllexport)
+#else
+#define PLAGCHECK_API __declspec(dllimport)
+#endif
+#else
+#define PLAGCHECK_API __attribute__((visibility("default")))
+#endif
+#else
+#define PLAGCHECK_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* C接口的版本，接口发生不兼容的变化时加一 */
+#define PLAGCHECK_ABI_VERSION 1
+
+#define PLAGCHECK_OK 0
+#define PLAGCHECK_ERROR (-1)
+
+/* 分词引擎，与命令行的 --tokenizer fast|icu|dict 对应 */
+#define PLAGCHECK_TOKENIZER_FAST 0
+#define PLAGCHECK_TOKENIZER_ICU 1
+#define PLAGCHECK_TOKENIZER_DICT 2
+
+/*
+    @brief 不透明的查重上下文
+*/
+typedef struct plagcheck_context plagcheck_context;
+
+/*
+    @brief 创建上下文的配置，先用 plagcheck_options_init 填入默认值
+    @param ngram 以几个单词的n-gram为特征，取值[1, 5]
+    @param tokenizer 分词引擎，PLAGCHECK_TOKENIZER_*
+    @param dictionary_path PLAGCHECK_TOKENIZER_DICT使用的词典文件，其他引擎可为NULL
+    @param cache_path 指纹缓存文件，为NULL时不使用缓存
+*/
+typedef struct plagcheck_options {
+    int ngram;
+    int tokenizer;
+    const char* dictionary_path;
+    const char* cache_path;
+} plagcheck_options;
+
+/*
+    @brief 获取库实现的C接口版本，调用方可与 PLAGCHECK_ABI_VERSION 比较
+*/
+PLAGCHECK_API int plagcheck_abi_version(void);
+
+/*
+    @brief 填入默认配置：1-gram、fast分词引擎、不使用词典与缓存
+*/
+PLAGCHECK_API void plagcheck_options_init(plagcheck_options* options);
+
+/*
+    @brief 创建上下文
+    @param options 配置，为NULL时使用默认配置
+    @return 返回上下文，失败时返回NULL
+*/
+PLAGCHECK_API plagcheck_context* plagcheck_context_create(const plagcheck_options* options);
+
+/*
+    @brief 销毁上下文，不会自动保存指纹缓存
+    @param context 上下文，可以为NULL
+*/
+PLAGCHECK_API void plagcheck_context_destroy(plagcheck_context* context);
+
+/*
+    @brief 计算一段UTF-8文本的SimHash值
+    @param context 上下文
+    @param text 文本，不要求以0结尾
+    @param length 文本字节数
+    @param fingerprint 写入SimHash值
+    @param words 非NULL时写入单词数，为0表示文本中没有单词
+    @return 返回状态码
+*/
+PLAGCHECK_API int plagcheck_fingerprint(plagcheck_context* context, const char* text, size_t length,
+    uint64_t* fingerprint, uint64_t* words);
+
+/*
+    @brief 计算两个SimHash值之间的汉明距离
+*/
+PLAGCHECK_API int plagcheck_distance(uint64_t fingerprint1, uint64_t fingerprint2);
+
+/*
+    @brief 由两个SimHash值计算[0, 1]之间的相似度
+*/
+PLAGCHECK_API double plagcheck_compare(uint64_t fingerprint1, uint64_t fingerprint2);
+
+/*
+    @brief 计算两段UTF-8文本的相似度，结果与命令行两文件比较相同
+    @param context 上下文
+    @param original 原文
+    @param original_length 原文字节数
+    @param copyed 被查重的文本
+    @param copyed_length 被查重文本的字节数
+    @param similarity 写入相似度
+    @return 返回状态码
+*/
+PLAGCHECK_API int plagcheck_similarity(plagcheck_context* context, const char* original, size_t original_length,
+    const char* copyed, size_t copyed_length, double* similarity);
+
+/*
+    @brief 保存上下文的指纹缓存，没有配置缓存时什么也不做
+    @return 返回状态码
+*/
+PLAGCHECK_API int plagcheck_save_cache(plagcheck_context* context);
+
+/*
+    @brief 获取当前线程最近一次失败的错误信息
+    @return 返回以0结尾的字符串，在当前线程下一次调用失败前有效；没有错误时返回空字符串
+*/
+PLAGCHECK_API const char* plagcheck_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
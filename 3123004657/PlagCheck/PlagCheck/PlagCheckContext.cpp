@@ -0,0 +1,80 @@
+#include "PlagCheckContext.h"
+#include "PlagCheck.h"
+#include "Shingle.h"
+#include "TrieDictionary.h"
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    PlagCheckContext::PlagCheckContext(const ContextOptions& options)
+        : settings(options) {
+        if (options.ngram < 1 || options.ngram > ShingleRoller::maxSize) {
+            throw std::invalid_argument("shingle size must be in [1, 5].");
+        }
+        std::shared_ptr<const TrieDictionary> dictionary;
+        if (options.engine == TokenizerEngine::Dictionary) {
+            if (options.dictionaryPath.empty()) {
+                throw std::invalid_argument("the dictionary engine requires a dictionary file.");
+            }
+            dictionary = std::make_shared<TrieDictionary>(options.dictionaryPath);
+        }
+        tokenizer.use_engine(options.engine, std::move(dictionary));
+        //缓存键由本上下文的引擎与词典决定，与进程内的全局分词设置无关
+        segmenter = tokenizer.segmenter_id();
+        if (!options.cachePath.empty()) {
+            cache = std::make_unique<FingerprintCache>(options.cachePath);
+        }
+    }
+
+    std::bitset<64> PlagCheckContext::fingerprint(std::string_view content, std::uint64_t* wordCount) {
+        CacheEntry entry;
+        ContentKey key = {};
+        if (cache) {
+            key = FingerprintCache::key_of(content, settings.ngram, segmenter);
+            if (cache->lookup(key, entry)) {
+                if (wordCount != nullptr) {
+                    *wordCount = entry.words;
+                }
+                return entry.fingerprint;
+            }
+        }
+        tokenizer.tokenize(content, words);
+        SimHashAccumulator accumulator;
+        accumulate_simhash(words, settings.ngram, accumulator);
+        if (wordCount != nullptr) {
+            *wordCount = words.size();
+        }
+        if (cache) {
+            entry.words = words.size();
+            entry.counters = accumulator.counters();
+            entry.fingerprint = accumulator.fingerprint();
+            cache->store(key, entry);
+        }
+        return accumulator.fingerprint();
+    }
+
+    double PlagCheckContext::compare(const std::bitset<64>& hash1, const std::bitset<64>& hash2) {
+        return similarity_from_distance(hamming_distance(hash1, hash2));
+    }
+
+    double PlagCheckContext::similarity(std::string_view original, std::string_view copyed) {
+        std::uint64_t orgWords = 0;
+        std::uint64_t copyWords = 0;
+        std::bitset<64> hash1 = fingerprint(original, &orgWords);
+        std::bitset<64> hash2 = fingerprint(copyed, &copyWords);
+        if (orgWords == 0 || copyWords == 0) {
+            return 0.00;
+        }
+        return compare(hash1, hash2);
+    }
+
+    void PlagCheckContext::save_cache() const {
+        if (cache) {
+            cache->save();
+        }
+    }
+
+    const ContextOptions& PlagCheckContext::options() const {
+        return settings;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "Tokenizer.h"
+#include "FingerprintCache.h"
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief PlagCheckContext的配置
+        @param ngram 以几个单词的n-gram为SimHash特征，取值[1, 5]
+        @param engine 分词引擎
+        @param dictionaryPath Dictionary引擎使用的词典文件（由 --build-dict 生成）
+        @param cachePath 指纹缓存文件，为空时不使用缓存
+    */
+    struct ContextOptions {
+        int ngram = 1;
+        TokenizerEngine engine = TokenizerEngine::AsciiFast;
+        std::string dictionaryPath;
+        std::string cachePath;
+    };
+
+    /*
+        @brief 供嵌入调用的查重上下文
+        @details 持有自己的分词器、单词缓冲区、哈希配置与可选的指纹缓存，不依赖进程内的全局分词设置，
+                 同一进程中可以并存多个配置不同的上下文；缓存键包含上下文自己的引擎与词典，
+                 配置不同的上下文即使使用同一个缓存文件也不会读到对方的指纹。分词器与缓冲区在多次调用之间复用，
+                 fingerprint在缓冲区容量足够后不再分配内存（写入缓存的未命中除外），compare只做一次popcount。
+                 上下文不是线程安全的，每个线程应使用自己的实例。
+        @method fingerprint 计算一段文本的SimHash值
+        @method compare 由两个SimHash值计算相似度
+        @method similarity 计算两段文本的相似度
+        @method save_cache 保存指纹缓存
+    */
+    class PlagCheckContext {
+    public:
+        /*
+            @brief 构造函数，按配置加载词典与指纹缓存
+            @param options 配置
+            @throws invalid_argument 如果ngram不在[1, 5]之间，或选择Dictionary引擎但没有给出词典文件
+            @throws runtime_error 如果词典或缓存文件无法加载
+        */
+        explicit PlagCheckContext(const ContextOptions& options = ContextOptions());
+
+        PlagCheckContext(const PlagCheckContext&) = delete;
+        PlagCheckContext& operator=(const PlagCheckContext&) = delete;
+
+        /*
+            @brief 计算一段文本的SimHash值，结果与 compute_fingerprint 相同
+            @param content 输入的文本
+            @param wordCount 非空时写入文本的单词数，为0表示文本中没有单词
+            @return 返回文本的SimHash值
+        */
+        std::bitset<64> fingerprint(std::string_view content, std::uint64_t* wordCount = nullptr);
+
+        /*
+            @brief 由两个SimHash值计算相似度
+            @param hash1 第一个SimHash值
+            @param hash2 第二个SimHash值
+            @return 返回[0, 1]之间的相似度
+        */
+        static double compare(const std::bitset<64>& hash1, const std::bitset<64>& hash2);
+
+        /*
+            @brief 计算两段文本的相似度，结果与 calcu_simi 相同
+            @param original 原文
+            @param copyed 被查重的文本
+            @return 返回[0, 1]之间的相似度，任一文本没有单词时返回0
+        */
+        double similarity(std::string_view original, std::string_view copyed);
+
+        /*
+            @brief 若配置了指纹缓存且有新记录，则保存到缓存文件
+            @throws runtime_error 如果文件无法写入
+        */
+        void save_cache() const;
+
+        /*
+            @brief 获取配置
+        */
+        const ContextOptions& options() const;
+
+    private:
+        ContextOptions settings;
+        Tokenizer tokenizer;
+        SegmenterId segmenter;
+        std::vector<std::string_view> words;
+        std::unique_ptr<FingerprintCache> cache;
+    };
+}
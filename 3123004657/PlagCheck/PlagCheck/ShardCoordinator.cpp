@@ -0,0 +1,90 @@
+#include "ShardCoordinator.h"
+#include "Daemon.h"
+#include "Stats.h"
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    static bool closer(const ShardMatch& a, const ShardMatch& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.docId < b.docId;
+    }
+
+    /*
+        @brief 解析topk响应，每行为 "文档 汉明距离 相似度"，文档标识可能含空格，从行尾取字段
+    */
+    static std::vector<ShardMatch> parse_matches(const std::string& body) {
+        std::vector<ShardMatch> matches;
+        std::istringstream lines(body);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            std::size_t scoreSpace = line.rfind(' ');
+            std::size_t distanceSpace = scoreSpace == std::string::npos || scoreSpace == 0
+                ? std::string::npos : line.rfind(' ', scoreSpace - 1);
+            if (distanceSpace == std::string::npos) {
+                throw std::runtime_error("malformed shard response: " + line);
+            }
+            matches.push_back({ line.substr(0, distanceSpace),
+                std::stoi(line.substr(distanceSpace + 1, scoreSpace - distanceSpace - 1)) });
+        }
+        return matches;
+    }
+
+    std::vector<ShardMatch> merge_top_k(const std::vector<std::vector<ShardMatch>>& shards, std::size_t k) {
+        std::vector<ShardMatch> merged;
+        for (const auto& shard : shards) {
+            merged.insert(merged.end(), shard.begin(), shard.end());
+        }
+        k = std::min(k, merged.size());
+        std::partial_sort(merged.begin(), merged.begin() + static_cast<std::ptrdiff_t>(k), merged.end(), closer);
+        merged.resize(k);
+        return merged;
+    }
+
+    ShardCoordinator::ShardCoordinator(std::vector<std::string> workerPaths)
+        : workers(std::move(workerPaths)) {
+        if (workers.empty()) {
+            throw std::invalid_argument("at least one shard worker is required.");
+        }
+    }
+
+    std::vector<ShardMatch> ShardCoordinator::top_k(const std::bitset<64>& fingerprint, std::size_t k, int ngram,
+        const SegmenterId& segmenter) const {
+        ScopedTimer timer(Phase::Compare);
+        std::string command = "topk " + std::to_string(k) + " " + encode_fingerprint(fingerprint) + " " + std::to_string(ngram) +
+            " " + std::to_string(segmenter.engine) + " " + std::to_string(segmenter.dictionary);
+        std::vector<std::vector<ShardMatch>> results(workers.size());
+        std::vector<std::string> errors(workers.size());
+        {
+            //每个分片一个线程，总耗时取决于最慢的分片
+            WorkStealingPool pool(static_cast<unsigned>(workers.size()));
+            for (std::size_t i = 0; i < workers.size(); ++i) {
+                pool.submit([&, i] {
+                    try {
+                        LocalSocket socket = LocalSocket::connect(workers[i]);
+                        results[i] = parse_matches(daemon_request(socket, command, {}));
+                    }
+                    catch (const std::exception& e) {
+                        errors[i] = workers[i] + ": " + e.what();
+                    }
+                });
+            }
+            pool.wait();
+        }
+        for (const auto& error : errors) {
+            if (!error.empty()) {
+                throw std::runtime_error("shard query failed: " + error);
+            }
+        }
+        return merge_top_k(results, k);
+    }
+
+    std::size_t ShardCoordinator::shard_count() const {
+        return workers.size();
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "Tokenizer.h"
+#include <bitset>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 分片检索的一条结果
+        @param docId 文档标识
+        @param distance 与查询指纹的汉明距离
+    */
+    struct ShardMatch {
+        std::string docId;
+        int distance;
+    };
+
+    /*
+        @brief 合并各分片的top-k结果
+        @details 按汉明距离升序、距离相同时按文档标识排序，取前k个。
+                 各分片也按同样的顺序取前k个，因此合并结果与在整个语料库上直接取top-k相同。
+        @param shards 各分片的结果
+        @param k 保留的结果数
+        @return 返回合并后的前k个结果
+    */
+    std::vector<ShardMatch> merge_top_k(const std::vector<std::vector<ShardMatch>>& shards, std::size_t k);
+
+    /*
+        @brief 分片检索的协调器
+        @details 每个分片由一个 --shard-worker 进程持有（见Daemon），协调器只保存各分片的套接字路径。
+                 查询时在本地计算一次指纹，并发地向所有分片发送topk请求，再用merge_top_k合并。
+                 单机测试时在localhost上启动多个工作进程即可。
+        @method top_k 查询与指纹最接近的k篇文档
+    */
+    class ShardCoordinator {
+    public:
+        /*
+            @brief 构造函数
+            @param workerPaths 各分片工作进程的套接字路径
+            @throws invalid_argument 如果没有任何分片
+        */
+        explicit ShardCoordinator(std::vector<std::string> workerPaths);
+
+        /*
+            @brief 查询与指纹最接近的k篇文档
+            @param fingerprint 查询的SimHash值
+            @param k 返回的结果数
+            @param ngram 生成查询指纹时使用的n-gram大小，分片的索引必须与之相同
+            @param segmenter 生成查询指纹时使用的分词配置，分片的索引必须与之相同
+            @return 返回按汉明距离升序排列的结果
+            @throws runtime_error 如果任何一个分片无法连接或返回错误
+        */
+        std::vector<ShardMatch> top_k(const std::bitset<64>& fingerprint, std::size_t k, int ngram,
+            const SegmenterId& segmenter) const;
+
+        /*
+            @brief 获取分片数
+        */
+        std::size_t shard_count() const;
+
+    private:
+        std::vector<std::string> workers;
+    };
+}
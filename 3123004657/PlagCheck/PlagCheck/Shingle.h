@@ -0,0 +1,94 @@
+#pragma once
+#include "Hashing.h"
+#include <cstdint>
+#include <stdexcept>
+
+namespace PlagCheck {
+    /*
+        @brief 单词n-gram（shingle）滚动哈希
+        @details 依次输入每个单词的哈希值，窗口满n个单词后每输入一个单词产出一个n-gram哈希。
+                 窗口内用 h = h × B + 单词哈希 的多项式哈希滚动更新，移出最早的单词只需减去
+                 其哈希乘以 B^(n-1)，全程不拼接、不分配n-gram字符串。
+                 n大于1时输出再经过一次splitmix64混合，使低位同样依赖单词顺序；
+                 n为1时原样输出单词哈希，与不使用shingle的结果完全相同。
+        @method push 输入一个单词哈希，窗口满时输出n-gram哈希
+        @method reset 清空窗口，开始新的单词序列
+    */
+    class ShingleRoller {
+    public:
+        static const int maxSize = 5;
+
+        /*
+            @brief 构造函数
+            @param n n-gram中的单词数
+            @throws invalid_argument 如果n不在[1, 5]之间
+        */
+        explicit ShingleRoller(int n = 1)
+            : size(n)
+        {
+            if (n < 1 || n > maxSize) {
+                throw std::invalid_argument("shingle size must be in [1, 5].");
+            }
+            highPower = 1;
+            for (int i = 1; i < n; ++i) {
+                highPower *= base;
+            }
+        }
+
+        /*
+            @brief 输入一个单词的哈希值
+            @param tokenHash 单词的哈希值
+            @param shingle 窗口已满时写入当前n-gram的哈希值
+            @return 如果产出了n-gram哈希返回true，否则返回false
+        */
+        bool push(std::uint64_t tokenHash, std::uint64_t& shingle)
+        {
+            if (size == 1) {
+                shingle = tokenHash;
+                return true;
+            }
+            if (filled == size) {
+                value -= window[head] * highPower;
+            }
+            else {
+                ++filled;
+            }
+            value = value * base + tokenHash;
+            window[head] = tokenHash;
+            head = (head + 1) % size;
+            if (filled < size) {
+                return false;
+            }
+            shingle = mix64(value);
+            return true;
+        }
+
+        /*
+            @brief 清空窗口
+        */
+        void reset()
+        {
+            filled = 0;
+            head = 0;
+            value = 0;
+        }
+
+        /*
+            @brief 获取n-gram中的单词数
+        */
+        int n() const
+        {
+            return size;
+        }
+
+    private:
+        static const std::uint64_t base = 0x100000001B3ULL;
+
+        int size;
+        int filled = 0;
+        int head = 0;
+        std::uint64_t value = 0;
+        std::uint64_t highPower;
+        std::uint64_t window[maxSize] = { 0 };
+    };
+}
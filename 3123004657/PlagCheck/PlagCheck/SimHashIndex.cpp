@@ -0,0 +1,169 @@
+#include "SimHashIndex.h"
+#include "PlagCheck.h"
+#include "Stats.h"
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+
+namespace PlagCheck {
+
+    SimHashIndex::SimHashIndex(int max_distance)
+        : maxDistance(max_distance) {
+        if (max_distance < 0 || max_distance > 63) {
+            throw std::invalid_argument("max_distance must be in [0, 63].");
+        }
+        //把64位尽量均匀地切成 max_distance + 1 块
+        int blocks = max_distance + 1;
+        int offset = 0;
+        for (int b = 0; b < blocks; ++b) {
+            int bits = 64 / blocks + (b < 64 % blocks ? 1 : 0);
+            Table table;
+            table.bits = bits;
+            table.shift = (64 - offset - bits) % 64;
+            tables.push_back(std::move(table));
+            offset += bits;
+        }
+    }
+
+    std::uint64_t SimHashIndex::rotl(std::uint64_t value, int shift) {
+        shift &= 63;
+        if (shift == 0) {
+            return value;
+        }
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    std::size_t SimHashIndex::add(const std::string& doc_id, const std::bitset<64>& fingerprint) {
+        if (docIds.size() >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("SimHashIndex is full.");
+        }
+        std::uint32_t doc = static_cast<std::uint32_t>(docIds.size());
+        docIds.push_back(doc_id);
+        fingerprints.push_back(fingerprint);
+        std::uint64_t value = fingerprint.to_ullong();
+        for (auto& table : tables) {
+            table.entries.emplace_back(rotl(value, table.shift), doc);
+        }
+        built = false;
+        return doc;
+    }
+
+    void SimHashIndex::build() {
+        for (auto& table : tables) {
+            std::sort(table.entries.begin(), table.entries.end());
+        }
+        built = true;
+    }
+
+    std::vector<SimHashIndex::Match> SimHashIndex::query(const std::bitset<64>& fingerprint, int k) const {
+        if (!built) {
+            throw std::logic_error("SimHashIndex::build must be called before query.");
+        }
+        ScopedTimer timer(Phase::Compare);
+        if (k > maxDistance) {
+            return linear_scan(fingerprint, k);
+        }
+        std::vector<Match> matches;
+        if (k < 0) {
+            return matches;
+        }
+        std::uint64_t value = fingerprint.to_ullong();
+        for (std::size_t t = 0; t < tables.size(); ++t) {
+            const Table& table = tables[t];
+            std::uint64_t key = rotl(value, table.shift);
+            std::uint64_t low_mask = table.bits == 64 ? 0 : (~0ULL >> table.bits);
+            std::uint64_t lo = key & ~low_mask;
+            std::uint64_t hi = key | low_mask;
+            auto first = std::lower_bound(table.entries.begin(), table.entries.end(),
+                std::make_pair(lo, std::uint32_t{ 0 }));
+            for (auto it = first; it != table.entries.end() && it->first <= hi; ++it) {
+                //若候选在更靠前的表中已经命中过，则跳过，避免重复结果
+                std::uint64_t diff = rotl(it->first, -table.shift) ^ value;
+                bool seen = false;
+                for (std::size_t p = 0; p < t && !seen; ++p) {
+                    std::uint64_t mask = rotl(~(~0ULL >> tables[p].bits), -tables[p].shift);
+                    seen = (diff & mask) == 0;
+                }
+                if (seen) {
+                    continue;
+                }
+                int distance = hamming_distance(fingerprint, fingerprints[it->second]);
+                if (distance <= k) {
+                    matches.push_back({ it->second, distance });
+                }
+            }
+        }
+        std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+            return a.distance != b.distance ? a.distance < b.distance : a.doc < b.doc;
+        });
+        return matches;
+    }
+
+    std::vector<SimHashIndex::Match> SimHashIndex::linear_scan(const std::bitset<64>& fingerprint, int k) const {
+        std::vector<Match> matches;
+        for (std::size_t doc = 0; doc < fingerprints.size(); ++doc) {
+            int distance = hamming_distance(fingerprint, fingerprints[doc]);
+            if (distance <= k) {
+                matches.push_back({ doc, distance });
+            }
+        }
+        std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+            return a.distance != b.distance ? a.distance < b.distance : a.doc < b.doc;
+        });
+        return matches;
+    }
+
+    std::vector<SimHashIndex::Match> SimHashIndex::top_k(const std::bitset<64>& fingerprint, std::size_t k) const {
+        std::vector<Match> matches = query(fingerprint, maxDistance);
+        if (matches.size() >= k) {
+            matches.resize(k);
+            return matches;
+        }
+        ScopedTimer timer(Phase::Compare);
+        //堆顶是当前第k好的结果，(距离, 下标) 越大越靠近堆顶
+        auto worse = [](const Match& a, const Match& b) {
+            return a.distance != b.distance ? a.distance < b.distance : a.doc < b.doc;
+        };
+        std::vector<Match> heap = std::move(matches);
+        std::make_heap(heap.begin(), heap.end(), worse);
+        //置换表已经给出全部距离不超过maxDistance的文档，剩余文档的距离至少为maxDistance + 1，
+        //且按下标顺序扫描，距离相同的后来者下标更大，不会替换堆中的结果
+        const int bound = maxDistance + 1;
+        for (std::size_t doc = 0; doc < fingerprints.size(); ++doc) {
+            if (heap.size() == k && heap.front().distance <= bound) {
+                break;
+            }
+            int distance = hamming_distance(fingerprint, fingerprints[doc]);
+            if (distance < bound) {
+                continue;
+            }
+            if (heap.size() < k) {
+                heap.push_back({ doc, distance });
+                std::push_heap(heap.begin(), heap.end(), worse);
+            }
+            else if (distance < heap.front().distance) {
+                std::pop_heap(heap.begin(), heap.end(), worse);
+                heap.back() = { doc, distance };
+                std::push_heap(heap.begin(), heap.end(), worse);
+            }
+        }
+        std::sort_heap(heap.begin(), heap.end(), worse);
+        return heap;
+    }
+
+    const std::string& SimHashIndex::doc_id(std::size_t doc) const {
+        return docIds.at(doc);
+    }
+
+    const std::bitset<64>& SimHashIndex::fingerprint(std::size_t doc) const {
+        return fingerprints.at(doc);
+    }
+
+    std::size_t SimHashIndex::size() const {
+        return docIds.size();
+    }
+
+    int SimHashIndex::max_distance() const {
+        return maxDistance;
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <bitset>
+#include <cstdint>
+#include <utility>
+
+namespace PlagCheck {
+    /*
+        @brief 基于置换分块表的SimHash近邻索引
+        @details 将64位指纹切分为 max_distance + 1 个块，每张表把其中一个块循环移位到最高位后排序。
+                 由鸽巢原理，汉明距离不超过 max_distance 的两个指纹至少在一个块上完全相同，
+                 因此查询只需在每张表中二分查找相同前缀的区间，再用 hamming_distance 精确校验，
+                 无需扫描整个语料库。
+        @method add 添加一篇文档的指纹
+        @method build 对所有表排序，查询前必须调用
+        @method query 查询汉明距离不超过k的全部文档
+        @method top_k 查询汉明距离最小的k篇文档
+    */
+    class SimHashIndex {
+    public:
+        /*
+            @brief 一条查询结果
+            @param doc 文档在索引中的下标
+            @param distance 与查询指纹的汉明距离
+        */
+        struct Match {
+            std::size_t doc;
+            int distance;
+        };
+
+        /*
+            @brief 构造函数
+            @param max_distance 索引能够以亚线性时间回答的最大汉明距离
+            @throws invalid_argument 如果max_distance不在[0, 63]之间
+        */
+        explicit SimHashIndex(int max_distance = 3);
+
+        /*
+            @brief 添加一篇文档的指纹
+            @param doc_id 文档标识（通常为文件路径）
+            @param fingerprint 文档的SimHash值
+            @return 返回文档在索引中的下标
+        */
+        std::size_t add(const std::string& doc_id, const std::bitset<64>& fingerprint);
+
+        /*
+            @brief 对所有置换表排序，添加完文档后、查询前调用
+        */
+        void build();
+
+        /*
+            @brief 查询与给定指纹汉明距离不超过k的全部文档
+            @param fingerprint 查询的SimHash值
+            @param k 汉明距离阈值，超过max_distance时退化为线性扫描
+            @return 返回按距离升序排列的查询结果
+            @throws logic_error 如果索引尚未build
+        */
+        std::vector<Match> query(const std::bitset<64>& fingerprint, int k) const;
+
+        /*
+            @brief 查询与给定指纹汉明距离最小的k篇文档
+            @details 先在置换表中查出距离不超过max_distance的全部文档，够k篇时即为答案；
+                     不够时说明其余文档的距离都大于max_distance，再按下标顺序扫描其余文档，
+                     用容量为k的最大堆保留当前最好的k篇，堆满且第k好的距离已等于剩余文档可能的最小距离时提前结束。
+            @param fingerprint 查询的SimHash值
+            @param k 返回的文档数，超过文档总数时返回全部文档
+            @return 返回按距离升序排列的查询结果，距离相同时下标小的在前
+            @throws logic_error 如果索引尚未build
+        */
+        std::vector<Match> top_k(const std::bitset<64>& fingerprint, std::size_t k) const;
+
+        /*
+            @brief 获取文档标识
+            @param doc 文档下标
+            @return 返回文档标识
+        */
+        const std::string& doc_id(std::size_t doc) const;
+
+        /*
+            @brief 获取文档指纹
+            @param doc 文档下标
+            @return 返回文档的SimHash值
+        */
+        const std::bitset<64>& fingerprint(std::size_t doc) const;
+
+        /*
+            @brief 获取索引中的文档数量
+        */
+        std::size_t size() const;
+
+        /*
+            @brief 获取索引支持的最大汉明距离
+        */
+        int max_distance() const;
+
+    private:
+        /*
+            @brief 一张置换表
+            @param shift 把该块移到最高位所需的循环左移位数
+            @param bits 该块的位数
+            @param entries 置换后的指纹与文档下标，按指纹排序
+        */
+        struct Table {
+            int shift;
+            int bits;
+            std::vector<std::pair<std::uint64_t, std::uint32_t>> entries;
+        };
+
+        int maxDistance;
+        bool built = false;
+        std::vector<Table> tables;
+        std::vector<std::string> docIds;
+        std::vector<std::bitset<64>> fingerprints;
+
+        static std::uint64_t rotl(std::uint64_t value, int shift);
+        std::vector<Match> linear_scan(const std::bitset<64>& fingerprint, int k) const;
+    };
+}
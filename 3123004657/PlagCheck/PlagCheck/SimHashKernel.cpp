@@ -0,0 +1,116 @@
+#include "SimHashKernel.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PLAGCHECK_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(PLAGCHECK_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PLAGCHECK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PLAGCHECK_TARGET_AVX2
+#endif
+
+namespace PlagCheck {
+
+    void accumulate_simhash_scalar(const std::uint64_t* hashes, std::size_t count, std::int32_t* counters) {
+        for (std::size_t n = 0; n < count; ++n) {
+            std::uint64_t hash = hashes[n];
+            for (int i = 0; i < 64; ++i) {
+                counters[i] += static_cast<std::int32_t>((hash >> i) & 1) * 2 - 1;
+            }
+        }
+    }
+
+#if defined(PLAGCHECK_X86)
+    /*
+        @brief AVX2内核：64位哈希拆成4段16位，每段广播到16个16位通道，
+               与各通道的位掩码比较得到±1，用饱和减法累加到16位计数器
+    */
+    PLAGCHECK_TARGET_AVX2
+    void accumulate_simhash_avx2(const std::uint64_t* hashes, std::size_t count, std::int32_t* counters) {
+        //16位计数器在块长不超过32767时不会饱和，保证与标量实现逐位一致
+        const std::size_t block = 32767;
+        const __m256i bitMask = _mm256_setr_epi16(
+            0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080,
+            0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x2000, 0x4000, static_cast<short>(0x8000));
+        const __m256i one = _mm256_set1_epi16(1);
+        for (std::size_t begin = 0; begin < count; begin += block) {
+            std::size_t end = std::min(count, begin + block);
+            __m256i acc[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(),
+                _mm256_setzero_si256(), _mm256_setzero_si256() };
+            for (std::size_t n = begin; n < end; ++n) {
+                std::uint64_t hash = hashes[n];
+                for (int c = 0; c < 4; ++c) {
+                    __m256i chunk = _mm256_set1_epi16(static_cast<short>(hash >> (16 * c)));
+                    //位为1的通道得到-1，为0的通道得到+1，减去后即为+1/-1
+                    __m256i set = _mm256_cmpeq_epi16(_mm256_and_si256(chunk, bitMask), bitMask);
+                    acc[c] = _mm256_subs_epi16(acc[c], _mm256_or_si256(set, one));
+                }
+            }
+            //把16位计数器扩展为32位并加到结果上
+            for (int c = 0; c < 4; ++c) {
+                __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(acc[c]));
+                __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(acc[c], 1));
+                __m256i* out = reinterpret_cast<__m256i*>(counters + 16 * c);
+                _mm256_storeu_si256(out, _mm256_add_epi32(_mm256_loadu_si256(out), lo));
+                _mm256_storeu_si256(out + 1, _mm256_add_epi32(_mm256_loadu_si256(out + 1), hi));
+            }
+        }
+    }
+
+    bool cpu_has_avx2() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#else
+    void accumulate_simhash_avx2(const std::uint64_t* hashes, std::size_t count, std::int32_t* counters) {
+        accumulate_simhash_scalar(hashes, count, counters);
+    }
+
+    bool cpu_has_avx2() {
+        return false;
+    }
+#endif
+
+    using AccumulateKernel = void (*)(const std::uint64_t*, std::size_t, std::int32_t*);
+
+    /*
+        @brief 选定的内核，在首次使用时根据CPU特性确定
+    */
+    static AccumulateKernel selected_kernel() {
+#if defined(PLAGCHECK_X86)
+        static const AccumulateKernel kernel = cpu_has_avx2() ? accumulate_simhash_avx2 : accumulate_simhash_scalar;
+#else
+        static const AccumulateKernel kernel = accumulate_simhash_scalar;
+#endif
+        return kernel;
+    }
+
+    void accumulate_simhash(const std::uint64_t* hashes, std::size_t count, std::int32_t* counters) {
+        selected_kernel()(hashes, count, counters);
+    }
+
+    const char* simhash_kernel_name() {
+        return selected_kernel() == accumulate_simhash_scalar ? "scalar" : "avx2";
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include "Hashing.h"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace PlagCheck {
+    /*
+        @brief 把一批64位哈希值累加到64个有符号计数器上
+        @details 每个哈希值的第i位为1时 counters[i] 加一，否则减一。
+                 支持AVX2的CPU上使用向量化内核：把哈希值展开为±1的16位通道，
+                 按块在16位饱和计数器中累加后再扩展到32位；否则使用标量实现。
+                 内核在程序启动时根据CPU特性选定，两种实现的结果完全相同。
+        @param hashes 哈希值数组
+        @param count 哈希值个数
+        @param counters 64个计数器，结果累加到其中
+    */
+    void accumulate_simhash(const std::uint64_t* hashes, std::size_t count, std::int32_t* counters);
+
+    /*
+        @brief accumulate_simhash 的标量实现，供校验与不支持AVX2的平台使用
+    */
+    void accumulate_simhash_scalar(const std::uint64_t* hashes, std::size_t count, std::int32_t* counters);
+
+    /*
+        @brief accumulate_simhash 的AVX2实现，供校验使用，调用前需确认 cpu_has_avx2() 为true
+        @details 非x86平台上等同于标量实现
+    */
+    void accumulate_simhash_avx2(const std::uint64_t* hashes, std::size_t count, std::int32_t* counters);
+
+    /*
+        @brief 获取当前选用的累加内核名称
+        @return 返回 "avx2" 或 "scalar"
+    */
+    const char* simhash_kernel_name();
+
+    /*
+        @brief 检测CPU与操作系统是否支持AVX2，供各个向量化内核选择实现
+        @return 非x86平台总是返回false
+    */
+    bool cpu_has_avx2();
+
+    /*
+        @brief 由特征哈希派生第lane条哈希通道
+        @details 第0条通道就是特征哈希本身，因此64位指纹与只有一条通道时完全相同；
+                 其余通道经 splitmix64 混合得到，与第0条通道及彼此之间相互独立。
+        @param hash 特征哈希
+        @param lane 通道编号
+        @return 返回该通道的64位哈希值
+    */
+    inline std::uint64_t simhash_lane(std::uint64_t hash, std::size_t lane)
+    {
+        return lane == 0 ? hash : mix64(hash + lane);
+    }
+
+    /*
+        @brief SimHash累加器
+        @details 保存Bits个有符号计数器与已累加的单词数，可以分批添加哈希值、
+                 合并其他累加器，最后取计数器的符号得到SimHash值。
+                 Bits为64的倍数，每64位对应一条哈希通道，每条通道用 accumulate_simhash 内核累加到各自的64个计数器上。
+        @param Bits 指纹位数，取64、128或256
+        @method add 累加哈希值
+        @method merge 合并另一个累加器
+        @method subtract 减去另一个累加器
+        @method fingerprint 生成SimHash值
+    */
+    template <std::size_t Bits>
+    class BasicSimHashAccumulator {
+    public:
+        static_assert(Bits == 64 || Bits == 128 || Bits == 256, "SimHash width must be 64, 128 or 256 bits.");
+
+        static constexpr std::size_t lanes = Bits / 64;
+
+        /*
+            @brief 累加一批特征哈希值
+            @param hashes 哈希值数组
+            @param count 哈希值个数
+        */
+        void add(const std::uint64_t* hashes, std::size_t count)
+        {
+            accumulate_simhash(hashes, count, counterValues.data());
+            if constexpr (lanes > 1) {
+                //其余通道分批派生后交给同一个内核
+                std::uint64_t derived[256];
+                for (std::size_t begin = 0; begin < count; begin += std::size(derived)) {
+                    std::size_t length = std::min(count - begin, std::size(derived));
+                    for (std::size_t lane = 1; lane < lanes; ++lane) {
+                        for (std::size_t n = 0; n < length; ++n) {
+                            derived[n] = simhash_lane(hashes[begin + n], lane);
+                        }
+                        accumulate_simhash(derived, length, counterValues.data() + 64 * lane);
+                    }
+                }
+            }
+            tokenCount += count;
+        }
+
+        /*
+            @brief 累加一个特征哈希值
+            @param hash 哈希值
+        */
+        void add(std::uint64_t hash)
+        {
+            add(&hash, 1);
+        }
+
+        /*
+            @brief 合并另一个累加器的计数器
+            @param other 另一个累加器
+        */
+        void merge(const BasicSimHashAccumulator& other)
+        {
+            for (std::size_t i = 0; i < Bits; ++i) {
+                counterValues[i] += other.counterValues[i];
+            }
+            tokenCount += other.tokenCount;
+        }
+
+        /*
+            @brief 减去另一个累加器的计数器，撤销之前累加过的同一批哈希值
+            @param other 另一个累加器
+        */
+        void subtract(const BasicSimHashAccumulator& other)
+        {
+            for (std::size_t i = 0; i < Bits; ++i) {
+                counterValues[i] -= other.counterValues[i];
+            }
+            tokenCount -= other.tokenCount;
+        }
+
+        /*
+            @brief 由计数器生成SimHash值，计数器大于0的位置为1
+            @return 返回SimHash值，第 64 * lane + i 位来自第lane条通道的第i位
+        */
+        std::bitset<Bits> fingerprint() const
+        {
+            std::bitset<Bits> simhash;
+            for (std::size_t i = 0; i < Bits; ++i) {
+                if (counterValues[i] > 0) {
+                    simhash.set(i);
+                }
+            }
+            return simhash;
+        }
+
+        /*
+            @brief 获取Bits个计数器
+        */
+        const std::array<std::int32_t, Bits>& counters() const
+        {
+            return counterValues;
+        }
+
+        /*
+            @brief 获取已累加的哈希值个数
+        */
+        std::uint64_t tokens() const
+        {
+            return tokenCount;
+        }
+
+        /*
+            @brief 清空计数器
+        */
+        void reset()
+        {
+            counterValues.fill(0);
+            tokenCount = 0;
+        }
+
+    private:
+        std::array<std::int32_t, Bits> counterValues{};
+        std::uint64_t tokenCount = 0;
+    };
+
+    /*
+        @brief 默认的64位SimHash累加器
+    */
+    using SimHashAccumulator = BasicSimHashAccumulator<64>;
+}
@@ -0,0 +1,279 @@
+#include "Socket.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace PlagCheck {
+
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+    static const NativeSocket invalidSocket = INVALID_SOCKET;
+
+    /*
+        @brief 进程内只初始化一次Winsock
+    */
+    static void ensure_winsock() {
+        static const bool started = [] {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        if (!started) {
+            throw std::runtime_error("Failed to initialize Winsock.");
+        }
+    }
+
+    static void close_native(NativeSocket s) {
+        closesocket(s);
+    }
+
+    static void remove_socket_file(const std::string& path) {
+        DeleteFileA(path.c_str());
+    }
+#else
+    using NativeSocket = int;
+    static const NativeSocket invalidSocket = -1;
+
+    static void ensure_winsock() {
+    }
+
+    static void close_native(NativeSocket s) {
+        ::close(s);
+    }
+
+    static void remove_socket_file(const std::string& path) {
+        ::unlink(path.c_str());
+    }
+#endif
+
+    /*
+        @brief 填写AF_UNIX地址
+        @throws runtime_error 如果路径超过sun_path的长度
+    */
+    static sockaddr_un make_address(const std::string& path) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path is too long: " + path);
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
+
+    LocalSocket::LocalSocket(std::intptr_t handle)
+        : handle(handle) {
+    }
+
+    LocalSocket::~LocalSocket() {
+        close();
+    }
+
+    LocalSocket::LocalSocket(LocalSocket&& other) noexcept
+        : handle(other.handle) {
+        other.handle = -1;
+    }
+
+    LocalSocket& LocalSocket::operator=(LocalSocket&& other) noexcept {
+        if (this != &other) {
+            close();
+            handle = other.handle;
+            other.handle = -1;
+        }
+        return *this;
+    }
+
+    LocalSocket LocalSocket::connect(const std::string& path) {
+        ensure_winsock();
+        NativeSocket s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (s == invalidSocket) {
+            throw std::runtime_error("Failed to create socket.");
+        }
+        LocalSocket socket(static_cast<std::intptr_t>(s));
+        sockaddr_un address = make_address(path);
+        if (::connect(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            throw std::runtime_error("Failed to connect to " + path);
+        }
+        return socket;
+    }
+
+    bool LocalSocket::is_open() const {
+        return handle != -1;
+    }
+
+    std::intptr_t LocalSocket::native_handle() const {
+        return handle;
+    }
+
+    void LocalSocket::send_all(const char* data, std::size_t size) {
+        while (size > 0) {
+            int chunk = static_cast<int>(std::min<std::size_t>(size, 1u << 30));
+#ifdef _WIN32
+            int sent = ::send(static_cast<NativeSocket>(handle), data, chunk, 0);
+#else
+            //对端已关闭时不产生SIGPIPE，改为返回错误
+            int flags = 0;
+#ifdef MSG_NOSIGNAL
+            flags = MSG_NOSIGNAL;
+#endif
+            ssize_t sent = ::send(static_cast<NativeSocket>(handle), data, static_cast<std::size_t>(chunk), flags);
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+#endif
+            if (sent <= 0) {
+                throw std::runtime_error("Socket connection closed while sending.");
+            }
+            data += sent;
+            size -= static_cast<std::size_t>(sent);
+        }
+    }
+
+    bool LocalSocket::recv_all(char* data, std::size_t size) {
+        std::size_t received = 0;
+        while (received < size) {
+            int chunk = static_cast<int>(std::min<std::size_t>(size - received, 1u << 30));
+#ifdef _WIN32
+            int got = ::recv(static_cast<NativeSocket>(handle), data + received, chunk, 0);
+#else
+            ssize_t got = ::recv(static_cast<NativeSocket>(handle), data + received, static_cast<std::size_t>(chunk), 0);
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+#endif
+#ifdef _WIN32
+            bool timedOut = got < 0 && WSAGetLastError() == WSAETIMEDOUT;
+#else
+            bool timedOut = got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+#endif
+            if (timedOut) {
+                throw std::runtime_error("Socket receive timed out.");
+            }
+            if (got <= 0) {
+                if (received == 0 && got == 0) {
+                    return false;
+                }
+                throw std::runtime_error("Socket connection closed while receiving.");
+            }
+            received += static_cast<std::size_t>(got);
+        }
+        return true;
+    }
+
+    void LocalSocket::send_frame(std::string_view payload) {
+        if (payload.size() > maxFrameSize) {
+            throw std::runtime_error("Frame is too large.");
+        }
+        std::uint32_t size = static_cast<std::uint32_t>(payload.size());
+        char header[4];
+        for (int i = 0; i < 4; ++i) {
+            header[i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+        }
+        send_all(header, sizeof(header));
+        send_all(payload.data(), payload.size());
+    }
+
+    bool LocalSocket::recv_frame(std::string& payload) {
+        unsigned char header[4];
+        if (!recv_all(reinterpret_cast<char*>(header), sizeof(header))) {
+            return false;
+        }
+        std::uint32_t size = 0;
+        for (int i = 0; i < 4; ++i) {
+            size |= static_cast<std::uint32_t>(header[i]) << (8 * i);
+        }
+        if (size > maxFrameSize) {
+            throw std::runtime_error("Frame is too large.");
+        }
+        payload.resize(size);
+        if (size > 0 && !recv_all(payload.data(), size)) {
+            throw std::runtime_error("Socket connection closed while receiving.");
+        }
+        return true;
+    }
+
+    void LocalSocket::set_receive_timeout(unsigned seconds) {
+#ifdef _WIN32
+        DWORD timeout = static_cast<DWORD>(seconds) * 1000;
+#else
+        timeval timeout{};
+        timeout.tv_sec = static_cast<decltype(timeout.tv_sec)>(seconds);
+#endif
+        if (::setsockopt(static_cast<NativeSocket>(handle), SOL_SOCKET, SO_RCVTIMEO,
+                reinterpret_cast<const char*>(&timeout), sizeof(timeout)) != 0) {
+            throw std::runtime_error("Failed to set socket receive timeout.");
+        }
+    }
+
+    void LocalSocket::shutdown() {
+        if (handle != -1) {
+#ifdef _WIN32
+            ::shutdown(static_cast<NativeSocket>(handle), SD_BOTH);
+#else
+            ::shutdown(static_cast<NativeSocket>(handle), SHUT_RDWR);
+#endif
+        }
+    }
+
+    void LocalSocket::close() {
+        if (handle != -1) {
+            close_native(static_cast<NativeSocket>(handle));
+            handle = -1;
+        }
+    }
+
+    LocalListener::LocalListener(const std::string& path)
+        : socketPath(path) {
+        ensure_winsock();
+        sockaddr_un address = make_address(path);
+        NativeSocket s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (s == invalidSocket) {
+            throw std::runtime_error("Failed to create socket.");
+        }
+        listener = LocalSocket(static_cast<std::intptr_t>(s));
+        //上次异常退出残留的套接字文件会导致bind失败
+        remove_socket_file(path);
+        if (::bind(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            throw std::runtime_error("Failed to bind socket: " + path);
+        }
+        if (::listen(s, SOMAXCONN) != 0) {
+            throw std::runtime_error("Failed to listen on socket: " + path);
+        }
+    }
+
+    LocalListener::~LocalListener() {
+        listener.close();
+        remove_socket_file(socketPath);
+    }
+
+    LocalSocket LocalListener::accept() {
+        while (true) {
+            NativeSocket s = ::accept(static_cast<NativeSocket>(listener.native_handle()), nullptr, nullptr);
+            if (s != invalidSocket) {
+                return LocalSocket(static_cast<std::intptr_t>(s));
+            }
+#ifndef _WIN32
+            if (errno == EINTR) {
+                continue;
+            }
+#endif
+            throw std::runtime_error("Failed to accept connection on " + socketPath);
+        }
+    }
+
+    const std::string& LocalListener::path() const {
+        return socketPath;
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace PlagCheck {
+    /*
+        @brief 本地流式套接字（Unix domain socket）的一端
+        @details Linux/macOS使用AF_UNIX，Windows 10 1803起通过afunix.h提供同样的AF_UNIX支持。
+                 只能移动不能复制，析构时关闭套接字。
+        @method send_all 发送全部数据
+        @method recv_all 接收恰好指定长度的数据
+        @method send_frame 发送一帧：4字节小端长度 + 内容
+        @method recv_frame 接收一帧
+    */
+    class LocalSocket {
+    public:
+        //一帧允许的最大字节数，超过时视为协议错误
+        static const std::uint32_t maxFrameSize = 256u * 1024 * 1024;
+
+        LocalSocket() = default;
+
+        /*
+            @brief 接管一个已经打开的套接字句柄
+        */
+        explicit LocalSocket(std::intptr_t handle);
+
+        ~LocalSocket();
+
+        LocalSocket(LocalSocket&& other) noexcept;
+        LocalSocket& operator=(LocalSocket&& other) noexcept;
+        LocalSocket(const LocalSocket&) = delete;
+        LocalSocket& operator=(const LocalSocket&) = delete;
+
+        /*
+            @brief 连接到监听在path上的服务端
+            @param path 套接字文件路径
+            @return 返回已连接的套接字
+            @throws runtime_error 如果连接失败
+        */
+        static LocalSocket connect(const std::string& path);
+
+        /*
+            @brief 判断套接字是否有效
+        */
+        bool is_open() const;
+
+        /*
+            @brief 获取底层的套接字句柄
+        */
+        std::intptr_t native_handle() const;
+
+        /*
+            @brief 发送全部数据
+            @throws runtime_error 如果连接已断开
+        */
+        void send_all(const char* data, std::size_t size);
+
+        /*
+            @brief 接收恰好size字节
+            @return 对端在读到任何数据之前关闭连接时返回false
+            @throws runtime_error 如果读取到一半连接断开或等待超时
+        */
+        bool recv_all(char* data, std::size_t size);
+
+        /*
+            @brief 发送一帧
+            @param payload 帧内容
+            @throws runtime_error 如果内容超过maxFrameSize或连接已断开
+        */
+        void send_frame(std::string_view payload);
+
+        /*
+            @brief 接收一帧
+            @param payload 写入帧内容
+            @return 对端正常关闭连接时返回false
+            @throws runtime_error 如果帧长度超过maxFrameSize、连接中途断开或等待超时
+        */
+        bool recv_frame(std::string& payload);
+
+        /*
+            @brief 设置接收超时，超过时间没有收到数据时recv_all抛出异常
+            @param seconds 超时秒数，0表示不超时
+            @throws runtime_error 如果设置失败
+        */
+        void set_receive_timeout(unsigned seconds);
+
+        /*
+            @brief 关闭读写两个方向，使阻塞在该套接字上的recv立即返回，但不释放句柄
+        */
+        void shutdown();
+
+        /*
+            @brief 关闭套接字
+        */
+        void close();
+
+    private:
+        std::intptr_t handle = -1;
+    };
+
+    /*
+        @brief 监听本地套接字
+        @details 构造时删除同名的残留套接字文件后绑定，析构时关闭并删除套接字文件
+        @method accept 等待并接受一个连接
+    */
+    class LocalListener {
+    public:
+        /*
+            @brief 构造函数，绑定并开始监听
+            @param path 套接字文件路径
+            @throws runtime_error 如果路径过长或绑定失败
+        */
+        explicit LocalListener(const std::string& path);
+
+        ~LocalListener();
+
+        LocalListener(const LocalListener&) = delete;
+        LocalListener& operator=(const LocalListener&) = delete;
+
+        /*
+            @brief 等待并接受一个连接
+            @return 返回已连接的套接字
+            @throws runtime_error 如果监听套接字出错
+        */
+        LocalSocket accept();
+
+        /*
+            @brief 获取套接字文件路径
+        */
+        const std::string& path() const;
+
+    private:
+        std::string socketPath;
+        LocalSocket listener;
+    };
+}
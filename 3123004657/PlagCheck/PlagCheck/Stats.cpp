@@ -0,0 +1,106 @@
+#include "Stats.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace PlagCheck {
+
+    static const char* const phaseNames[] = { "read", "tokenize", "hash", "compare" };
+    static const std::size_t phaseCount = static_cast<std::size_t>(Phase::Count);
+
+    static std::atomic<std::uint64_t> phaseNanoseconds[phaseCount];
+    static std::atomic<std::uint64_t> phaseCalls[phaseCount];
+    static std::atomic<std::uint64_t> bytesRead{ 0 };
+    static std::atomic<std::uint64_t> tokenCount{ 0 };
+    static std::atomic<std::uint64_t> hashCount{ 0 };
+    static std::chrono::steady_clock::time_point startTime;
+
+    void Stats::enable() {
+        startTime = std::chrono::steady_clock::now();
+        active.store(true, std::memory_order_relaxed);
+    }
+
+    void Stats::add_time(Phase phase, std::uint64_t nanoseconds) {
+        std::size_t index = static_cast<std::size_t>(phase);
+        phaseNanoseconds[index].fetch_add(nanoseconds, std::memory_order_relaxed);
+        phaseCalls[index].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Stats::add_bytes(std::uint64_t bytes) {
+        bytesRead.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void Stats::add_tokens(std::uint64_t tokens) {
+        tokenCount.fetch_add(tokens, std::memory_order_relaxed);
+    }
+
+    void Stats::add_hashes(std::uint64_t hashes) {
+        hashCount.fetch_add(hashes, std::memory_order_relaxed);
+    }
+
+    std::uint64_t Stats::peak_rss() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return static_cast<std::uint64_t>(counters.PeakWorkingSetSize);
+        }
+        return 0;
+#else
+        struct rusage usage {};
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+#ifdef __APPLE__
+        return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+        //Linux上ru_maxrss的单位是KB
+        return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    std::string Stats::to_json() {
+        double wall = active.load(std::memory_order_relaxed)
+            ? std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()
+            : 0.0;
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(6);
+        json << "{\n";
+        json << "  \"wall_seconds\": " << wall << ",\n";
+        json << "  \"peak_rss_bytes\": " << peak_rss() << ",\n";
+        json << "  \"bytes_read\": " << bytesRead.load() << ",\n";
+        json << "  \"tokens\": " << tokenCount.load() << ",\n";
+        json << "  \"hashed_features\": " << hashCount.load() << ",\n";
+        json << "  \"phases\": {\n";
+        for (std::size_t i = 0; i < phaseCount; ++i) {
+            json << "    \"" << phaseNames[i] << "\": { \"seconds\": "
+                 << static_cast<double>(phaseNanoseconds[i].load()) / 1e9
+                 << ", \"calls\": " << phaseCalls[i].load() << " }"
+                 << (i + 1 < phaseCount ? ",\n" : "\n");
+        }
+        json << "  }\n";
+        json << "}\n";
+        return json.str();
+    }
+
+    void Stats::write(const std::string& path) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open stats file: " + path);
+        }
+        out << to_json();
+        if (!out) {
+            throw std::runtime_error("Failed to write stats file: " + path);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace PlagCheck {
+    /*
+        @brief 统计的阶段
+        @param Read 读取文件
+        @param Tokenize ICU分词
+        @param Hash 单词哈希与SimHash累加
+        @param Compare 指纹比较、索引查询与全量互查
+    */
+    enum class Phase {
+        Read,
+        Tokenize,
+        Hash,
+        Compare,
+        Count
+    };
+
+    /*
+        @brief 进程内的性能统计
+        @details 记录各阶段耗时与调用次数、读取的字节数、分词得到的单词数、哈希的特征数和峰值内存。
+                 计数器均为原子变量，多线程模式下各线程的阶段耗时累加，因此可能超过总耗时。
+                 未调用enable时每个统计点只有一次relaxed原子读，几乎没有开销；
+                 统计只在文档粒度上进行，不进入逐词循环。
+        @method enable 开始统计并记录起始时间
+        @method enabled 判断是否正在统计
+        @method add_time 累加一个阶段的耗时
+        @method add_bytes 累加读取的字节数
+        @method add_tokens 累加分词得到的单词数
+        @method add_hashes 累加哈希的特征数
+        @method peak_rss 获取进程的峰值常驻内存
+        @method to_json 生成JSON格式的统计报告
+        @method write 把统计报告写入文件
+    */
+    class Stats {
+    public:
+        /*
+            @brief 开始统计，之后的统计点才会记录数据
+        */
+        static void enable();
+
+        /*
+            @brief 判断是否正在统计
+        */
+        static bool enabled()
+        {
+            return active.load(std::memory_order_relaxed);
+        }
+
+        /*
+            @brief 累加一个阶段的耗时，并把该阶段的调用次数加一
+            @param phase 阶段
+            @param nanoseconds 耗时（纳秒）
+        */
+        static void add_time(Phase phase, std::uint64_t nanoseconds);
+
+        /*
+            @brief 累加读取的字节数
+        */
+        static void add_bytes(std::uint64_t bytes);
+
+        /*
+            @brief 累加分词得到的单词数
+        */
+        static void add_tokens(std::uint64_t tokens);
+
+        /*
+            @brief 累加哈希并累加到SimHash的特征（单词或n-gram）数
+        */
+        static void add_hashes(std::uint64_t hashes);
+
+        /*
+            @brief 获取进程的峰值常驻内存
+            @return 返回字节数，平台不支持时返回0
+        */
+        static std::uint64_t peak_rss();
+
+        /*
+            @brief 生成JSON格式的统计报告
+            @return 返回JSON字符串
+        */
+        static std::string to_json();
+
+        /*
+            @brief 把统计报告写入文件
+            @param path 文件路径
+            @throws runtime_error 如果文件无法写入
+        */
+        static void write(const std::string& path);
+
+    private:
+        inline static std::atomic<bool> active{ false };
+    };
+
+    /*
+        @brief 作用域计时器，构造时开始计时，析构时把耗时计入指定阶段
+        @details 未启用统计时不读取时钟
+    */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Phase phase)
+            : phase(phase), active(Stats::enabled())
+        {
+            if (active) {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedTimer()
+        {
+            if (active) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                Stats::add_time(phase, static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Phase phase;
+        bool active;
+        std::chrono::steady_clock::time_point start;
+    };
+}
@@ -0,0 +1,127 @@
+#include "StreamingSimHash.h"
+#include "FileMana.hpp"
+#include "PlagCheck.h"
+#include "TextBoundary.h"
+#include "Tokenizer.h"
+#include "Stats.h"
+#include <algorithm>
+
+namespace PlagCheck {
+
+    //找不到安全切分点时先继续累积；累积到这个大小后退回到ICU的最后一个边界切分，保证内存有上界
+    static const std::size_t maxPending = 16 * 1024 * 1024;
+
+    StreamingSimHash::StreamingSimHash(int ngram)
+        : ngram(ngram), roller(ngram) {
+    }
+
+    void StreamingSimHash::consume(const std::vector<std::string_view>& words) {
+        ScopedTimer timer(Phase::Hash);
+        if (Stats::enabled()) {
+            Stats::add_hashes(words.size());
+        }
+        std::uint64_t batch[256];
+        std::size_t filled = 0;
+        for (const auto& word : words) {
+            std::uint64_t hash = string_hash(word);
+            //记住开头的单词，文档不足n个单词时在finish中整体作为一个n-gram
+            if (wordCount < static_cast<std::uint64_t>(ngram)) {
+                firstHashes[wordCount] = hash;
+            }
+            ++wordCount;
+            if (!roller.push(hash, batch[filled])) {
+                continue;
+            }
+            if (++filled == std::size(batch)) {
+                simhash.add(batch, filled);
+                filled = 0;
+            }
+        }
+        simhash.add(batch, filled);
+    }
+
+    void StreamingSimHash::process(bool final) {
+        Tokenizer& tokenizer = Tokenizer::local();
+        std::string_view text(pending);
+        std::size_t consumed = 0;
+        if (final) {
+            tokenizer.tokenize(text, wordViews);
+            consumed = text.size();
+        }
+        else {
+            std::string_view complete = text.substr(0, utf8_complete_length(text));
+            std::size_t cut = last_safe_break(complete, scanned);
+            if (cut > 0) {
+                tokenizer.tokenize(complete.substr(0, cut), wordViews);
+                consumed = cut;
+            }
+            else if (complete.size() >= maxPending) {
+                consumed = tokenizer.tokenize_partial(complete, wordViews);
+                //整段只有一个片段时强制在完整字符处切开，否则pending会无限增长
+                if (consumed == 0) {
+                    tokenizer.tokenize(complete, wordViews);
+                    consumed = complete.size();
+                }
+            }
+            else {
+                //最后一个位置是否安全取决于下一个字符，留到下一块再检查
+                scanned = complete.empty() ? 0 : complete.size() - 1;
+            }
+        }
+        consume(wordViews);
+        wordViews.clear();
+        pending.erase(0, consumed);
+        if (consumed > 0) {
+            scanned = 0;
+        }
+    }
+
+    void StreamingSimHash::feed(std::string_view chunk) {
+        pending.append(chunk.data(), chunk.size());
+        process(false);
+    }
+
+    void StreamingSimHash::finish() {
+        process(true);
+        pending.clear();
+        pending.shrink_to_fit();
+        //与compute_simhash一致：单词数不足n个时整个序列作为一个n-gram
+        if (wordCount > 0 && wordCount < static_cast<std::uint64_t>(ngram)) {
+            ShingleRoller shortRoller(static_cast<int>(wordCount));
+            std::uint64_t shingle = 0;
+            for (std::uint64_t i = 0; i < wordCount; ++i) {
+                if (shortRoller.push(firstHashes[i], shingle)) {
+                    simhash.add(shingle);
+                }
+            }
+        }
+    }
+
+    std::bitset<64> StreamingSimHash::fingerprint() const {
+        return simhash.fingerprint();
+    }
+
+    std::uint64_t StreamingSimHash::words() const {
+        return wordCount;
+    }
+
+    const SimHashAccumulator& StreamingSimHash::accumulator() const {
+        return simhash;
+    }
+
+    std::bitset<64> fingerprint_file_streaming(const std::string& path, int ngram, std::size_t chunkSize,
+        std::uint64_t* words) {
+        FileManager file(path, true, false);
+        StreamingSimHash streaming(ngram);
+        std::vector<char> buffer(std::max<std::size_t>(chunkSize, 1));
+        std::size_t got = 0;
+        while ((got = file.read_chunk(buffer.data(), buffer.size())) > 0) {
+            streaming.feed(std::string_view(buffer.data(), got));
+        }
+        streaming.finish();
+        if (words != nullptr) {
+            *words = streaming.words();
+        }
+        return streaming.fingerprint();
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "Shingle.h"
+#include "SimHashKernel.h"
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 流式SimHash计算
+        @details 按块输入文本，分词后直接把单词（n-gram）哈希累加到计数器中，不保留整篇文档。
+                 每次只对最后一个安全切分点（空白或全角句读）之前的文本分词，之后的部分——
+                 包括块尾被截断的UTF-8字符和未结束的单词——留到下一块，因此结果与整篇分词相同。
+                 已扫描过的位置会被记住，每块只检查新到的字节，连续没有安全切分点的长文本不会被反复扫描。
+                 长时间没有安全切分点时，累积到16MB后退回到ICU的最后一个边界切分；
+                 连ICU边界也没有（一个超过16MB的单词）时，在最后一个完整的UTF-8字符处强制切开。
+                 峰值内存约为块大小加上一块的单词视图，与输入总大小无关。
+        @method feed 输入下一块文本
+        @method finish 输入结束，处理剩余文本
+        @method fingerprint 获取SimHash值
+    */
+    class StreamingSimHash {
+    public:
+        /*
+            @brief 构造函数
+            @param ngram n-gram中的单词数，取值[1, 5]
+            @throws invalid_argument 如果ngram不在[1, 5]之间
+        */
+        explicit StreamingSimHash(int ngram = 1);
+
+        /*
+            @brief 输入下一块文本
+            @param chunk 文本块，可以在任意字节处截断
+        */
+        void feed(std::string_view chunk);
+
+        /*
+            @brief 输入结束，处理保留的剩余文本
+        */
+        void finish();
+
+        /*
+            @brief 获取SimHash值，应在finish之后调用
+        */
+        std::bitset<64> fingerprint() const;
+
+        /*
+            @brief 获取已处理的单词数
+        */
+        std::uint64_t words() const;
+
+        /*
+            @brief 获取SimHash累加器
+        */
+        const SimHashAccumulator& accumulator() const;
+
+    private:
+        int ngram;
+        std::string pending;
+        std::size_t scanned = 0;
+        std::vector<std::string_view> wordViews;
+        std::uint64_t firstHashes[ShingleRoller::maxSize] = { 0 };
+        ShingleRoller roller;
+        SimHashAccumulator simhash;
+        std::uint64_t wordCount = 0;
+
+        void consume(const std::vector<std::string_view>& words);
+        void process(bool final);
+    };
+
+    /*
+        @brief 分块读取文件并计算SimHash值
+        @param path 文件路径
+        @param ngram n-gram中的单词数，取值[1, 5]
+        @param chunkSize 每次读取的字节数
+        @param words 不为nullptr时写入单词数
+        @return 返回文件的SimHash值
+        @throws runtime_error 如果文件无法读取
+    */
+    std::bitset<64> fingerprint_file_streaming(const std::string& path, int ngram = 1,
+        std::size_t chunkSize = 256 * 1024, std::uint64_t* words = nullptr);
+}
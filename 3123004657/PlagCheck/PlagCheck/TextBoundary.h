@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+namespace PlagCheck {
+    /*
+        @brief 计算不以残缺UTF-8序列结尾的最长前缀长度
+        @details 分块读取时，块尾可能截断一个多字节字符，残缺部分需要留到下一块
+        @param text 输入的字节序列
+        @return 返回完整前缀的字节数
+    */
+    inline std::size_t utf8_complete_length(std::string_view text) {
+        std::size_t size = text.size();
+        //最多回看3个字节寻找最后一个字符的首字节
+        for (std::size_t back = 1; back <= 4 && back <= size; ++back) {
+            unsigned char c = static_cast<unsigned char>(text[size - back]);
+            if ((c & 0xC0) == 0x80) {
+                continue;
+            }
+            std::size_t need = c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 1;
+            return need > back ? size - back : size;
+        }
+        return size;
+    }
+
+    /*
+        @brief 判断pos之前的字符是否构成安全的切分点
+        @details 换行之后一定是单词边界。ASCII空格、制表符以及全角的。！？之后通常也是边界，ICU的词典分词不会跨越它们，
+                 但ICU会把其后的Extend/Format/ZWJ字符并入前一个片段，并把连续的空格类字符（如 U+3000）合成一个片段，
+                 因此只有其后的字符确定是ASCII字符（空格之后不能再是空格）或U+4000～U+9FFF的汉字时才是安全切分点。
+                 全角的，；在ICU中属于MidNum，两侧都是数字时（如 1，000）会被并入同一个单词，
+                 因此只有其后的字符确定不是数字（ASCII非数字字符或汉字）时才是安全切分点。
+                 在这些位置切开文本分别分词，结果与整体分词相同
+        @param text 输入的文本
+        @param pos 候选切分位置（切分点之前字符的结尾）
+        @return 是安全切分点返回true
+    */
+    inline bool is_safe_break(std::string_view text, std::size_t pos) {
+        if (pos == 0 || pos > text.size()) {
+            return false;
+        }
+        unsigned char c = static_cast<unsigned char>(text[pos - 1]);
+        if (c == '\n' || c == '\r') {
+            return true;
+        }
+        //其余切分点都取决于下一个字符，下一个字符未知时不切分
+        if (pos == text.size()) {
+            return false;
+        }
+        unsigned char next = static_cast<unsigned char>(text[pos]);
+        bool nextHan = next >= 0xE4 && next <= 0xE9;
+        if (c == ' ') {
+            return (next < 0x80 && next != ' ') || nextHan;
+        }
+        if (c == '\t') {
+            return next < 0x80 || nextHan;
+        }
+        if (pos < 3) {
+            return false;
+        }
+        unsigned char a = static_cast<unsigned char>(text[pos - 3]);
+        unsigned char b = static_cast<unsigned char>(text[pos - 2]);
+        if (a == 0xE3 && b == 0x80 && c == 0x82) {
+            return next < 0x80 || nextHan;
+        }
+        if (a != 0xEF || b != 0xBC) {
+            return false;
+        }
+        if (c == 0x81 || c == 0x9F) {
+            return next < 0x80 || nextHan;
+        }
+        if (c != 0x9B && c != 0x8C) {
+            return false;
+        }
+        return (next < 0x80 && !(next >= '0' && next <= '9')) || nextHan;
+    }
+
+    /*
+        @brief 查找文本中最后一个安全切分点
+        @param text 输入的文本
+        @param from 只查找大于from的位置，调用者已确认from及之前没有安全切分点时用于跳过重复扫描
+        @return 返回最后一个安全切分点的位置，没有时返回0
+    */
+    inline std::size_t last_safe_break(std::string_view text, std::size_t from = 0) {
+        for (std::size_t pos = text.size(); pos > from; --pos) {
+            if (is_safe_break(text, pos)) {
+                return pos;
+            }
+        }
+        return 0;
+    }
+
+    /*
+        @brief 从pos开始向后查找第一个安全切分点
+        @details 只做逐字节比较，用于在分词前把大文本切成可以独立分词的片段
+        @param text 输入的文本
+        @param pos 开始查找的位置
+        @return 返回不小于pos的第一个安全切分点，没有时返回text.size()
+    */
+    inline std::size_t next_safe_break(std::string_view text, std::size_t pos) {
+        for (pos = pos == 0 ? 1 : pos; pos < text.size(); ++pos) {
+            if (is_safe_break(text, pos)) {
+                return pos;
+            }
+        }
+        return text.size();
+    }
+}
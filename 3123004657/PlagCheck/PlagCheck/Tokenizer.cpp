@@ -0,0 +1,220 @@
+#include "Tokenizer.h"
+#include "Stats.h"
+#include "AsciiTokenizer.h"
+#include <atomic>
+#include <cctype>
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    /*
+        @brief 获取进程内共享的原型BreakIterator，只在第一次调用时构造
+    */
+    static const icu::BreakIterator* prototype_iterator() {
+        static const std::unique_ptr<icu::BreakIterator> prototype = [] {
+            UErrorCode status = U_ZERO_ERROR;
+            std::unique_ptr<icu::BreakIterator> bi(icu::BreakIterator::createWordInstance(
+                icu::Locale::getChinese(), status));
+            if (U_FAILURE(status)) {
+                bi.reset();
+            }
+            return bi;
+        }();
+        return prototype.get();
+    }
+
+    Tokenizer::Tokenizer() {
+        const icu::BreakIterator* prototype = prototype_iterator();
+        if (prototype == nullptr) {
+            throw std::runtime_error("Failed to create ICU word break iterator.");
+        }
+        iterator.reset(prototype->clone());
+        if (!iterator) {
+            throw std::runtime_error("Failed to clone ICU word break iterator.");
+        }
+    }
+
+    Tokenizer::~Tokenizer() {
+        iterator.reset();
+        if (utext != nullptr) {
+            utext_close(utext);
+        }
+    }
+
+    void Tokenizer::tokenize(std::string_view text, std::vector<std::string_view>& words) {
+        segment(text, words, false);
+    }
+
+    std::size_t Tokenizer::tokenize_partial(std::string_view text, std::vector<std::string_view>& words) {
+        return segment(text, words, true);
+    }
+
+    static std::atomic<TokenizerEngine> currentEngine{ TokenizerEngine::AsciiFast };
+    static std::shared_ptr<const TrieDictionary> currentDictionary;
+
+    //ICU片段之后的ASCII片段短于此长度时并入ICU片段，避免中英混排文本被切成大量小片段
+    static const std::size_t minAsciiRun = 64;
+
+    static bool is_ascii_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    /*
+        @brief 从含非ASCII字符的位置向后，找到交给ICU的片段的结尾
+        @details 片段在一段ASCII空白之后、下一个ASCII非空白字符之前结束，ICU在这里一定会断开；
+                 之后的ASCII片段太短时继续向后合并
+        @param text 输入的文本
+        @param pos 片段内第一个非ASCII字节的位置
+        @return 返回片段的结尾
+    */
+    static std::size_t icu_span_end(std::string_view text, std::size_t pos) {
+        while (pos < text.size()) {
+            if (!is_ascii_space(text[pos])) {
+                ++pos;
+                continue;
+            }
+            while (pos < text.size() && is_ascii_space(text[pos])) {
+                ++pos;
+            }
+            if (pos == text.size() || static_cast<unsigned char>(text[pos]) >= 0x80) {
+                continue;
+            }
+            std::size_t next = find_non_ascii(text, pos);
+            if (next == text.size() || next - pos >= minAsciiRun) {
+                return pos;
+            }
+            pos = next;
+        }
+        return text.size();
+    }
+
+    std::size_t Tokenizer::segment(std::string_view text, std::vector<std::string_view>& words, bool holdLast) {
+        ScopedTimer timer(Phase::Tokenize);
+        words.clear();
+        std::size_t consumed = text.size();
+        TokenizerEngine selected = ownEngine ? engineOverride : currentEngine.load(std::memory_order_relaxed);
+        const TrieDictionary* dictionary = ownEngine ? dictionaryOverride.get() : currentDictionary.get();
+        //分块读取时最后一个片段需要由ICU确定，仍走ICU路径
+        if (holdLast || selected == TokenizerEngine::Icu) {
+            consumed = segment_icu(text, words, holdLast);
+        }
+        else {
+            segment_ascii_fast(text, words, selected == TokenizerEngine::Dictionary ? dictionary : nullptr);
+        }
+        if (Stats::enabled()) {
+            Stats::add_tokens(words.size());
+        }
+        return consumed;
+    }
+
+    void Tokenizer::segment_ascii_fast(std::string_view text, std::vector<std::string_view>& words, const TrieDictionary* dictionary) {
+        auto icu_fallback = [this, &words](std::string_view part) {
+            segment_icu(part, words, false);
+        };
+        std::size_t pos = 0;
+        while (pos < text.size()) {
+            std::size_t nonAscii = find_non_ascii(text, pos);
+            if (nonAscii == text.size()) {
+                tokenize_ascii(text.substr(pos), words);
+                return;
+            }
+            //ASCII部分在非ASCII字符之前最后一段空白的开头结束，空白之前ICU一定会断开
+            std::size_t cut = nonAscii;
+            while (cut > pos && !is_ascii_space(text[cut - 1])) {
+                --cut;
+            }
+            while (cut > pos && is_ascii_space(text[cut - 1])) {
+                --cut;
+            }
+            tokenize_ascii(text.substr(pos, cut - pos), words);
+            std::size_t end = icu_span_end(text, nonAscii);
+            if (dictionary != nullptr) {
+                dictionarySegmenter.segment(*dictionary, text.substr(cut, end - cut), words, icu_fallback);
+            }
+            else {
+                segment_icu(text.substr(cut, end - cut), words, false);
+            }
+            pos = end;
+        }
+    }
+
+    std::size_t Tokenizer::segment_icu(std::string_view text, std::vector<std::string_view>& words, bool holdLast) {
+        if (text.empty()) {
+            return 0;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        utext = utext_openUTF8(utext, text.data(), static_cast<int64_t>(text.size()), &status);
+        if (U_FAILURE(status)) {
+            return 0;
+        }
+        iterator->setText(utext, status);
+        if (U_FAILURE(status)) {
+            return 0;
+        }
+        int32_t start = iterator->first();
+        int32_t end = iterator->next();
+        while (end != icu::BreakIterator::DONE) {
+            //最后一个片段可能在下一块中继续，保留给调用者
+            if (holdLast && static_cast<std::size_t>(end) == text.size()) {
+                return static_cast<std::size_t>(start);
+            }
+            if (end > start) {
+                std::string_view word = text.substr(start, end - start);
+                bool is_punctuation = true;
+                for (char c : word) {
+                    if (!std::ispunct(static_cast<unsigned char>(c)) &&
+                        !std::isspace(static_cast<unsigned char>(c))) {
+                        is_punctuation = false;
+                        break;
+                    }
+                }
+                if (!is_punctuation) {
+                    words.push_back(word);
+                }
+            }
+            start = end;
+            end = iterator->next();
+        }
+        return text.size();
+    }
+
+    void Tokenizer::use_engine(TokenizerEngine engine, std::shared_ptr<const TrieDictionary> dictionary) {
+        if (engine == TokenizerEngine::Dictionary && !dictionary) {
+            throw std::logic_error("the dictionary engine requires a dictionary.");
+        }
+        ownEngine = true;
+        engineOverride = engine;
+        dictionaryOverride = std::move(dictionary);
+    }
+
+    SegmenterId Tokenizer::segmenter_id() const {
+        TokenizerEngine selected = ownEngine ? engineOverride : currentEngine.load(std::memory_order_relaxed);
+        const TrieDictionary* dictionary = ownEngine ? dictionaryOverride.get() : currentDictionary.get();
+        SegmenterId id;
+        id.engine = static_cast<std::uint32_t>(selected);
+        if (selected == TokenizerEngine::Dictionary && dictionary != nullptr) {
+            id.dictionary = dictionary->content_hash();
+        }
+        return id;
+    }
+
+    Tokenizer& Tokenizer::local() {
+        thread_local Tokenizer tokenizer;
+        return tokenizer;
+    }
+
+    void Tokenizer::set_engine(TokenizerEngine engine) {
+        if (engine == TokenizerEngine::Dictionary && !currentDictionary) {
+            throw std::logic_error("the dictionary engine requires a dictionary.");
+        }
+        currentEngine.store(engine, std::memory_order_relaxed);
+    }
+
+    TokenizerEngine Tokenizer::engine() {
+        return currentEngine.load(std::memory_order_relaxed);
+    }
+
+    void Tokenizer::set_dictionary(std::shared_ptr<const TrieDictionary> dictionary) {
+        currentDictionary = std::move(dictionary);
+    }
+}
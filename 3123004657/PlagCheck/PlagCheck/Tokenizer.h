@@ -0,0 +1,142 @@
+#pragma once
+#include "TrieDictionary.h"
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <unicode/brkiter.h>
+#include <unicode/utext.h>
+
+namespace PlagCheck {
+    /*
+        @brief 分词引擎
+        @param Icu 全部文本交给ICU的BreakIterator
+        @param AsciiFast 纯ASCII的片段用向量化的字节分类直接分词，只把含非ASCII字符的片段交给ICU，结果与Icu相同
+        @param Dictionary 与AsciiFast相同，但汉字改用双数组字典树词典分词，其余非ASCII文本与未登录词交给ICU
+    */
+    enum class TokenizerEngine {
+        Icu,
+        AsciiFast,
+        Dictionary
+    };
+
+    /*
+        @brief 分词配置的标识，标识不同的两种配置可能得到不同的分词结果
+        @details 用于指纹缓存的键与指纹文件的文件头，避免把一种分词配置算出的指纹用于另一种
+        @param engine 分词引擎，即TokenizerEngine的取值
+        @param dictionary Dictionary引擎所用词典的 content_hash，其他引擎为0
+    */
+    struct SegmenterId {
+        std::uint32_t engine = 0;
+        std::uint64_t dictionary = 0;
+
+        bool operator==(const SegmenterId& other) const
+        {
+            return engine == other.engine && dictionary == other.dictionary;
+        }
+
+        bool operator!=(const SegmenterId& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /*
+        @brief 可复用的分词器
+        @details 进程内只用 createWordInstance 构造一次原型BreakIterator，每个Tokenizer持有它的克隆，
+                 并复用同一个UText，分词结果以指向输入文本的 string_view 写入调用者提供的缓冲区，
+                 不复制文档、不为每个单词分配内存。
+                 默认使用AsciiFast引擎：英文文本不经过ICU，以ASCII空白为界把含非ASCII字符的片段交给ICU，
+                 在这些位置ICU一定会断开，拼接后的结果与整体交给ICU完全相同。
+                 Tokenizer不是线程安全的，每个线程应使用自己的实例（见local）。
+        @method tokenize 将文本拆分为单词
+        @method local 获取当前线程的分词器
+        @method use_engine 为本分词器单独指定引擎，不再跟随进程内的设置
+        @method segmenter_id 获取实际使用的分词配置的标识
+        @method set_engine 选择进程内所有分词器使用的引擎
+        @method set_dictionary 设置Dictionary引擎使用的词典
+    */
+    class Tokenizer {
+    public:
+        /*
+            @brief 构造函数，克隆进程内共享的原型BreakIterator
+            @throws runtime_error 如果ICU无法创建分词器
+        */
+        Tokenizer();
+
+        /*
+            @brief 析构函数，释放BreakIterator与UText
+        */
+        ~Tokenizer();
+
+        Tokenizer(const Tokenizer&) = delete;
+        Tokenizer& operator=(const Tokenizer&) = delete;
+
+        /*
+            @brief 将UTF-8文本拆分为单词，跳过只由标点和空白组成的片段
+            @param text 输入的文本，调用者需保证其在words使用期间有效
+            @param words 输出缓冲区，先被清空，再写入指向text的单词
+        */
+        void tokenize(std::string_view text, std::vector<std::string_view>& words);
+
+        /*
+            @brief 对可能在后续输入中继续的文本分词，最后一个片段不输出
+            @details 用于分块读取：最后一个片段可能是被块边界截断的单词，应与下一块拼接后再分词
+            @param text 输入的文本，调用者需保证其在words使用期间有效
+            @param words 输出缓冲区，先被清空，再写入最后一个片段之前的单词
+            @return 返回最后一个片段的起始位置，调用者应从此处保留文本
+        */
+        std::size_t tokenize_partial(std::string_view text, std::vector<std::string_view>& words);
+
+        /*
+            @brief 为本分词器单独指定引擎与词典，之后不再跟随 set_engine 与 set_dictionary 的设置
+            @details 供同一进程中使用不同配置的多个调用者（如多个PlagCheckContext）各自持有分词器
+            @param engine 分词引擎
+            @param dictionary Dictionary引擎使用的词典，其他引擎忽略
+            @throws logic_error 如果选择Dictionary引擎时dictionary为空
+        */
+        void use_engine(TokenizerEngine engine, std::shared_ptr<const TrieDictionary> dictionary = nullptr);
+
+        /*
+            @brief 获取本分词器实际使用的分词配置的标识
+            @return 指定了自己的引擎时返回该引擎与词典的标识，否则返回进程内设置的标识
+        */
+        SegmenterId segmenter_id() const;
+
+        /*
+            @brief 获取当前线程的分词器
+            @return 返回线程局部的Tokenizer实例
+        */
+        static Tokenizer& local();
+
+        /*
+            @brief 选择进程内所有分词器使用的引擎，应在开始分词前调用
+            @param engine 分词引擎
+            @throws logic_error 如果选择Dictionary引擎时还没有设置词典
+        */
+        static void set_engine(TokenizerEngine engine);
+
+        /*
+            @brief 设置Dictionary引擎使用的词典，应在开始分词前调用
+            @param dictionary 词典，由所有线程的分词器共享
+        */
+        static void set_dictionary(std::shared_ptr<const TrieDictionary> dictionary);
+
+        /*
+            @brief 获取当前的分词引擎
+        */
+        static TokenizerEngine engine();
+
+    private:
+        std::unique_ptr<icu::BreakIterator> iterator;
+        UText* utext = nullptr;
+        DictionarySegmenter dictionarySegmenter;
+        bool ownEngine = false;
+        TokenizerEngine engineOverride = TokenizerEngine::AsciiFast;
+        std::shared_ptr<const TrieDictionary> dictionaryOverride;
+
+        std::size_t segment(std::string_view text, std::vector<std::string_view>& words, bool holdLast);
+        std::size_t segment_icu(std::string_view text, std::vector<std::string_view>& words, bool holdLast);
+        void segment_ascii_fast(std::string_view text, std::vector<std::string_view>& words, const TrieDictionary* dictionary);
+    };
+}
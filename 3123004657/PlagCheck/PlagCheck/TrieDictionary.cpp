@@ -0,0 +1,437 @@
+#include "TrieDictionary.h"
+#include "Hashing.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace PlagCheck {
+
+    static const char dictionaryMagic[4] = { 'P', 'C', 'D', 'T' };
+
+    //标签0表示词在此结束，字节c的标签为c+1
+    static const int endLabel = 0;
+    static const int labelCount = 257;
+
+    /*
+        @brief 双数组构建器：按字典序递归地为每个节点的子节点寻找不冲突的base
+        @details 空闲单元串成双向循环链表，寻找base时只遍历空闲单元
+    */
+    class DoubleArrayBuilder {
+    public:
+        std::vector<TrieDictionary::Unit> units;
+
+        DoubleArrayBuilder(const std::vector<std::string>& words, const std::vector<float>& costs)
+            : words(words), costs(costs) {
+            grow(1024);
+            occupy(0, 0);
+            insert(0, 0, words.size(), 0);
+            //去掉末尾未使用的单元
+            std::size_t used = units.size();
+            while (used > 1 && units[used - 1].check < 0) {
+                --used;
+            }
+            units.resize(used);
+        }
+
+    private:
+        const std::vector<std::string>& words;
+        const std::vector<float>& costs;
+        std::vector<bool> usedBase;
+        std::vector<std::int32_t> nextFree;
+        std::vector<std::int32_t> prevFree;
+        std::int32_t freeHead = -1;
+
+        void grow(std::size_t size) {
+            if (size <= units.size()) {
+                return;
+            }
+            std::size_t oldSize = units.size();
+            std::size_t capacity = std::max(size, oldSize * 2);
+            units.resize(capacity, TrieDictionary::Unit{ 0, -1 });
+            usedBase.resize(capacity, false);
+            nextFree.resize(capacity);
+            prevFree.resize(capacity);
+            //新单元依次接到空闲链表末尾
+            for (std::size_t i = oldSize; i < capacity; ++i) {
+                std::int32_t unit = static_cast<std::int32_t>(i);
+                if (freeHead < 0) {
+                    freeHead = nextFree[i] = prevFree[i] = unit;
+                    continue;
+                }
+                std::int32_t tail = prevFree[static_cast<std::size_t>(freeHead)];
+                nextFree[static_cast<std::size_t>(tail)] = unit;
+                prevFree[i] = tail;
+                nextFree[i] = freeHead;
+                prevFree[static_cast<std::size_t>(freeHead)] = unit;
+            }
+        }
+
+        void occupy(std::size_t unit, std::int32_t parent) {
+            units[unit].check = parent;
+            std::int32_t next = nextFree[unit];
+            std::int32_t prev = prevFree[unit];
+            if (next == static_cast<std::int32_t>(unit)) {
+                freeHead = -1;
+                return;
+            }
+            nextFree[static_cast<std::size_t>(prev)] = next;
+            prevFree[static_cast<std::size_t>(next)] = prev;
+            if (freeHead == static_cast<std::int32_t>(unit)) {
+                freeHead = next;
+            }
+        }
+
+        static int label_of(const std::string& word, std::size_t depth) {
+            return depth == word.size() ? endLabel : static_cast<unsigned char>(word[depth]) + 1;
+        }
+
+        bool fits(std::size_t base, const std::vector<int>& labels) {
+            if (usedBase[base]) {
+                return false;
+            }
+            grow(base + labelCount);
+            for (std::size_t i = 1; i < labels.size(); ++i) {
+                if (units[base + static_cast<std::size_t>(labels[i])].check >= 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /*
+            @brief 寻找使全部子节点都落在空闲单元上的base
+        */
+        std::size_t find_base(const std::vector<int>& labels) {
+            std::size_t first = static_cast<std::size_t>(labels.front());
+            if (freeHead >= 0) {
+                std::int32_t unit = freeHead;
+                do {
+                    std::size_t pos = static_cast<std::size_t>(unit);
+                    if (pos > first && fits(pos - first, labels)) {
+                        return pos - first;
+                    }
+                    unit = nextFree[pos];
+                } while (unit != freeHead);
+            }
+            //没有合适的空闲单元时放在数组末尾之后
+            std::size_t base = units.size();
+            grow(base + labelCount);
+            return base;
+        }
+
+        /*
+            @brief 插入words[begin, end)，它们在depth之前的字节相同，对应节点node
+        */
+        void insert(std::int32_t node, std::size_t begin, std::size_t end, std::size_t depth) {
+            std::vector<int> labels;
+            std::vector<std::size_t> starts;
+            for (std::size_t i = begin; i < end; ++i) {
+                int label = label_of(words[i], depth);
+                if (labels.empty() || labels.back() != label) {
+                    labels.push_back(label);
+                    starts.push_back(i);
+                }
+            }
+            starts.push_back(end);
+            std::size_t base = find_base(labels);
+            usedBase[base] = true;
+            units[static_cast<std::size_t>(node)].base = static_cast<std::int32_t>(base);
+            for (int label : labels) {
+                occupy(base + static_cast<std::size_t>(label), node);
+            }
+            for (std::size_t c = 0; c < labels.size(); ++c) {
+                std::size_t target = base + static_cast<std::size_t>(labels[c]);
+                if (labels[c] == endLabel) {
+                    //按字典序排序且去重后，以此结束的词只有一个
+                    std::memcpy(&units[target].base, &costs[starts[c]], sizeof(float));
+                }
+                else {
+                    insert(static_cast<std::int32_t>(target), starts[c], starts[c + 1], depth + 1);
+                }
+            }
+        }
+    };
+
+    TrieDictionary::TrieDictionary(const std::vector<DictionaryEntry>& entries) {
+        std::map<std::string, double> merged;
+        for (const auto& entry : entries) {
+            if (entry.word.empty()) {
+                continue;
+            }
+            merged[entry.word] += std::max(entry.frequency, 1.0);
+        }
+        if (merged.empty()) {
+            throw std::invalid_argument("dictionary has no words.");
+        }
+        double total = 0.0;
+        for (const auto& item : merged) {
+            total += item.second;
+        }
+        std::vector<std::string> words;
+        std::vector<float> costs;
+        words.reserve(merged.size());
+        costs.reserve(merged.size());
+        double logTotal = std::log(total);
+        for (const auto& item : merged) {
+            words.push_back(item.first);
+            costs.push_back(static_cast<float>(logTotal - std::log(item.second)));
+        }
+        ownedUnits = std::move(DoubleArrayBuilder(words, costs).units);
+        units = ownedUnits.data();
+        unitCount = ownedUnits.size();
+        wordCount = words.size();
+        unknownCost = logTotal;
+    }
+
+    TrieDictionary::TrieDictionary(const std::string& path)
+        : file(std::make_unique<MappedFile>(path)) {
+        TrieDictionaryHeader header;
+        if (file->size() < sizeof(header)) {
+            throw std::runtime_error("Invalid dictionary file: " + path);
+        }
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (std::memcmp(header.magic, dictionaryMagic, sizeof(dictionaryMagic)) != 0) {
+            throw std::runtime_error("Invalid dictionary file: " + path);
+        }
+        if (header.version != currentVersion) {
+            throw std::runtime_error("Unsupported dictionary version: " + path);
+        }
+        std::uint64_t fileSize = file->size();
+        if (header.unitOffset % alignof(Unit) != 0 || header.unitOffset > fileSize ||
+            header.unitCount == 0 || header.unitCount > (fileSize - header.unitOffset) / sizeof(Unit)) {
+            throw std::runtime_error("Corrupted dictionary file: " + path);
+        }
+        units = reinterpret_cast<const Unit*>(file->data() + header.unitOffset);
+        unitCount = static_cast<std::size_t>(header.unitCount);
+        wordCount = static_cast<std::size_t>(header.wordCount);
+        unknownCost = header.unknownCost;
+    }
+
+    std::vector<DictionaryEntry> TrieDictionary::read_word_list(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            throw std::runtime_error("Failed to open word list: " + path);
+        }
+        std::vector<DictionaryEntry> entries;
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            DictionaryEntry entry;
+            if (!(fields >> entry.word) || entry.word[0] == '#') {
+                continue;
+            }
+            if (!(fields >> entry.frequency)) {
+                entry.frequency = 1.0;
+            }
+            entries.push_back(std::move(entry));
+        }
+        return entries;
+    }
+
+    void TrieDictionary::save(const std::string& path) const {
+        TrieDictionaryHeader header = {};
+        std::memcpy(header.magic, dictionaryMagic, sizeof(dictionaryMagic));
+        header.version = currentVersion;
+        header.wordCount = wordCount;
+        header.unitCount = unitCount;
+        header.unitOffset = sizeof(TrieDictionaryHeader);
+        header.unknownCost = unknownCost;
+        std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open dictionary file for writing: " + path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(units), static_cast<std::streamsize>(unitCount * sizeof(Unit)));
+        if (!out) {
+            throw std::runtime_error("Failed to write dictionary file: " + path);
+        }
+    }
+
+    std::int32_t TrieDictionary::child(std::int32_t node, int label) const {
+        std::int64_t target = static_cast<std::int64_t>(units[node].base) + label;
+        if (target <= 0 || target >= static_cast<std::int64_t>(unitCount) || units[target].check != node) {
+            return -1;
+        }
+        return static_cast<std::int32_t>(target);
+    }
+
+    std::size_t TrieDictionary::common_prefix_search(std::string_view text, PrefixMatch* matches, std::size_t maxMatches) const {
+        std::size_t count = 0;
+        std::int32_t node = 0;
+        for (std::size_t i = 0; i < text.size() && count < maxMatches; ++i) {
+            node = child(node, static_cast<unsigned char>(text[i]) + 1);
+            if (node < 0) {
+                break;
+            }
+            std::int32_t leaf = child(node, endLabel);
+            if (leaf >= 0) {
+                float cost;
+                std::memcpy(&cost, &units[leaf].base, sizeof(float));
+                matches[count++] = PrefixMatch{ static_cast<std::uint32_t>(i + 1), cost };
+            }
+        }
+        return count;
+    }
+
+    bool TrieDictionary::lookup(std::string_view word, float* cost) const {
+        std::int32_t node = 0;
+        for (char c : word) {
+            node = child(node, static_cast<unsigned char>(c) + 1);
+            if (node < 0) {
+                return false;
+            }
+        }
+        std::int32_t leaf = word.empty() ? -1 : child(node, endLabel);
+        if (leaf < 0) {
+            return false;
+        }
+        if (cost != nullptr) {
+            std::memcpy(cost, &units[leaf].base, sizeof(float));
+        }
+        return true;
+    }
+
+    double TrieDictionary::unknown_cost() const {
+        return unknownCost;
+    }
+
+    std::size_t TrieDictionary::size() const {
+        return wordCount;
+    }
+
+    std::size_t TrieDictionary::unit_count() const {
+        return unitCount;
+    }
+
+    std::uint64_t TrieDictionary::content_hash() const {
+        std::call_once(hashOnce, [this] {
+            //词的代价保存在叶子单元中，双数组相同即词与词频都相同
+            std::uint64_t seed = 0;
+            std::memcpy(&seed, &unknownCost, sizeof(seed));
+            contentHash = xxhash64(std::string_view(reinterpret_cast<const char*>(units), unitCount * sizeof(Unit)), seed);
+        });
+        return contentHash;
+    }
+
+    /*
+        @brief 解码pos处的UTF-8字符
+        @param length 写入字符的字节数，残缺或非法的序列按1字节计算
+        @return 返回码位，非法序列返回0xFFFD
+    */
+    static char32_t decode_utf8(std::string_view text, std::size_t pos, std::size_t& length) {
+        unsigned char c = static_cast<unsigned char>(text[pos]);
+        std::size_t need = c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 0;
+        if (need == 0 || pos + need > text.size()) {
+            length = 1;
+            return 0xFFFD;
+        }
+        char32_t code = need == 1 ? c : need == 2 ? (c & 0x1F) : need == 3 ? (c & 0x0F) : (c & 0x07);
+        for (std::size_t i = 1; i < need; ++i) {
+            unsigned char next = static_cast<unsigned char>(text[pos + i]);
+            if ((next & 0xC0) != 0x80) {
+                length = 1;
+                return 0xFFFD;
+            }
+            code = (code << 6) | (next & 0x3F);
+        }
+        length = need;
+        return code;
+    }
+
+    /*
+        @brief 判断码位是否为汉字（CJK统一表意文字及其扩展、兼容表意文字与〇）
+    */
+    static bool is_han(char32_t code) {
+        return (code >= 0x4E00 && code <= 0x9FFF) || (code >= 0x3400 && code <= 0x4DBF) ||
+            (code >= 0xF900 && code <= 0xFAFF) || (code >= 0x20000 && code <= 0x323AF) || code == 0x3007;
+    }
+
+    void DictionarySegmenter::segment(const TrieDictionary& dictionary, std::string_view text,
+        std::vector<std::string_view>& words, const Fallback& fallback) {
+        std::size_t gapBegin = 0;
+        std::size_t pos = 0;
+        while (pos < text.size()) {
+            std::size_t length;
+            if (!is_han(decode_utf8(text, pos, length))) {
+                pos += length;
+                continue;
+            }
+            std::size_t runEnd = pos + length;
+            while (runEnd < text.size() && is_han(decode_utf8(text, runEnd, length))) {
+                runEnd += length;
+            }
+            if (pos > gapBegin) {
+                fallback(text.substr(gapBegin, pos - gapBegin));
+            }
+            segment_han(dictionary, text.substr(pos, runEnd - pos), words, fallback);
+            gapBegin = pos = runEnd;
+        }
+        if (gapBegin < text.size()) {
+            fallback(text.substr(gapBegin));
+        }
+    }
+
+    void DictionarySegmenter::segment_han(const TrieDictionary& dictionary, std::string_view run,
+        std::vector<std::string_view>& words, const Fallback& fallback) {
+        //词典中的词最多取最短的64个，足以覆盖任何实际词表
+        const std::size_t maxMatches = 64;
+        std::size_t size = run.size();
+        routeCost.assign(size + 1, 0.0);
+        routeNext.assign(size + 1, 0);
+        matches.resize(maxMatches);
+        //从后向前动态规划，routeCost[i]为从i到结尾的最小代价；汉字都是3或4字节，只在字符起点计算
+        for (std::size_t i = size; i-- > 0;) {
+            if ((static_cast<unsigned char>(run[i]) & 0xC0) == 0x80) {
+                continue;
+            }
+            std::size_t charLength;
+            decode_utf8(run, i, charLength);
+            double best = dictionary.unknown_cost() + routeCost[i + charLength];
+            std::size_t bestEnd = i + charLength;
+            std::size_t found = dictionary.common_prefix_search(run.substr(i), matches.data(), maxMatches);
+            for (std::size_t m = 0; m < found; ++m) {
+                std::size_t end = i + matches[m].length;
+                double cost = matches[m].cost + routeCost[end];
+                //匹配按长度递增，<=使代价相同时取更长的词
+                if (cost <= best) {
+                    best = cost;
+                    bestEnd = end;
+                }
+            }
+            routeCost[i] = best;
+            routeNext[i] = static_cast<std::uint32_t>(bestEnd);
+        }
+        //沿最优路径输出，连续的词典外单字合并为未登录词片段
+        std::size_t unknownBegin = 0;
+        std::size_t unknownChars = 0;
+        auto flush_unknown = [&](std::size_t end) {
+            if (unknownChars == 1) {
+                words.push_back(run.substr(unknownBegin, end - unknownBegin));
+            }
+            else if (unknownChars > 1) {
+                fallback(run.substr(unknownBegin, end - unknownBegin));
+            }
+            unknownChars = 0;
+        };
+        for (std::size_t i = 0; i < size;) {
+            std::size_t end = routeNext[i];
+            std::size_t charLength;
+            decode_utf8(run, i, charLength);
+            if (end == i + charLength && !dictionary.lookup(run.substr(i, charLength))) {
+                if (unknownChars++ == 0) {
+                    unknownBegin = i;
+                }
+            }
+            else {
+                flush_unknown(i);
+                words.push_back(run.substr(i, end - i));
+            }
+            i = end;
+        }
+        flush_unknown(size);
+    }
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 词典中的一个词条
+        @param word UTF-8编码的词
+        @param frequency 词频，小于1时按1计算
+    */
+    struct DictionaryEntry {
+        std::string word;
+        double frequency = 1.0;
+    };
+
+    /*
+        @brief 词典文件的文件头
+        @details 文件布局（小端序）：文件头 | unitCount个双数组单元。
+                 每个单元为 (base, check) 两个32位整数，节点s经字节c转移到 base[s] + c + 1，
+                 转移有效当且仅当目标单元的check等于s；经标签0转移到的叶子单元表示词在此结束，
+                 叶子的base按位保存该词的代价（float，-log(词频/总词频)）。
+        @param magic 固定为 "PCDT"
+        @param version 文件格式版本
+        @param wordCount 词数
+        @param unitCount 双数组单元数
+        @param unitOffset 双数组在文件中的偏移
+        @param unknownCost 词典外单字的代价，相当于词频为1
+    */
+    struct TrieDictionaryHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t wordCount;
+        std::uint64_t unitCount;
+        std::uint64_t unitOffset;
+        double unknownCost;
+    };
+
+    /*
+        @brief 双数组字典树（double-array trie）词典
+        @details 可以由词条在内存中构建，也可以直接内存映射由save写出的词典文件，
+                 加载时只校验文件头，不复制、不解析双数组，几十万词的词典也能立即使用。
+                 按字节建树，查找一个位置开始的全部词只需沿双数组逐字节转移。
+        @method common_prefix_search 查找文本开头的全部词
+        @method lookup 查找一个词
+        @method save 写出词典文件
+        @method read_word_list 读取文本格式的词表
+    */
+    class TrieDictionary {
+    public:
+        static const std::uint32_t currentVersion = 1;
+
+        /*
+            @brief 一个前缀匹配结果
+            @param length 词的字节数
+            @param cost 词的代价
+        */
+        struct PrefixMatch {
+            std::uint32_t length;
+            float cost;
+        };
+
+        /*
+            @brief 双数组的一个单元
+        */
+        struct Unit {
+            std::int32_t base;
+            std::int32_t check;
+        };
+
+        /*
+            @brief 构造函数，由词条构建词典，重复的词合并词频
+            @param entries 词条
+            @throws invalid_argument 如果没有有效的词条
+        */
+        explicit TrieDictionary(const std::vector<DictionaryEntry>& entries);
+
+        /*
+            @brief 构造函数，映射并校验词典文件
+            @param path 文件路径
+            @throws runtime_error 如果文件无法打开或格式不正确
+        */
+        explicit TrieDictionary(const std::string& path);
+
+        TrieDictionary(const TrieDictionary&) = delete;
+        TrieDictionary& operator=(const TrieDictionary&) = delete;
+
+        /*
+            @brief 读取文本格式的词表
+            @details 每行一个词条："词 [词频] [词性]"，以空白分隔，与jieba的dict.txt格式兼容；
+                     省略词频时按1计算，空行和以#开头的行被忽略
+            @param path 词表路径
+            @return 返回词条
+            @throws runtime_error 如果文件无法打开
+        */
+        static std::vector<DictionaryEntry> read_word_list(const std::string& path);
+
+        /*
+            @brief 写出词典文件，之后可以用路径构造函数映射加载
+            @param path 文件路径
+            @throws runtime_error 如果文件无法写入
+        */
+        void save(const std::string& path) const;
+
+        /*
+            @brief 查找text开头的全部词
+            @param text 输入的文本
+            @param matches 输出缓冲区，按长度从短到长写入
+            @param maxMatches 缓冲区容量，超过时只保留最短的maxMatches个
+            @return 返回写入的匹配数
+        */
+        std::size_t common_prefix_search(std::string_view text, PrefixMatch* matches, std::size_t maxMatches) const;
+
+        /*
+            @brief 查找一个词
+            @param word 待查的词
+            @param cost 非空时写入词的代价
+            @return 词在词典中返回true
+        */
+        bool lookup(std::string_view word, float* cost = nullptr) const;
+
+        /*
+            @brief 获取词典外单字的代价
+        */
+        double unknown_cost() const;
+
+        /*
+            @brief 获取词数
+        */
+        std::size_t size() const;
+
+        /*
+            @brief 获取双数组单元数
+        */
+        std::size_t unit_count() const;
+
+        /*
+            @brief 获取词典内容的哈希值，用于区分不同词典得到的分词结果
+            @details 对双数组与未登录字代价做xxHash64，由词条构建与映射save写出的文件得到相同的值；
+                     第一次调用时计算，之后直接返回，可以在多个线程中同时调用
+        */
+        std::uint64_t content_hash() const;
+
+    private:
+        std::unique_ptr<MappedFile> file;
+        std::vector<Unit> ownedUnits;
+        const Unit* units = nullptr;
+        std::size_t unitCount = 0;
+        std::size_t wordCount = 0;
+        double unknownCost = 0.0;
+        mutable std::once_flag hashOnce;
+        mutable std::uint64_t contentHash = 0;
+
+        std::int32_t child(std::int32_t node, int label) const;
+    };
+
+    /*
+        @brief 基于词典的中文分词器
+        @details 只处理连续的汉字：对每个汉字位置用词典查出所有以它开头的词，构成有向无环图，
+                 从后向前动态规划求代价之和最小（概率最大）的切分路径，代价相同时取更长的词。
+                 路径上连续的词典外单字视为未登录词片段，整体交给调用者提供的回退分词器（通常是ICU）；
+                 汉字之间的其他文本（标点、假名、带音调的拉丁字母等）同样交给回退分词器。
+                 复用内部缓冲区，不是线程安全的。
+        @method segment 对一段文本分词
+    */
+    class DictionarySegmenter {
+    public:
+        using Fallback = std::function<void(std::string_view)>;
+
+        /*
+            @brief 对一段文本分词
+            @param dictionary 词典
+            @param text 输入的文本，调用者需保证其在words使用期间有效
+            @param words 单词追加到其末尾
+            @param fallback 处理非汉字文本与未登录词片段的分词器，结果应同样追加到words
+        */
+        void segment(const TrieDictionary& dictionary, std::string_view text,
+            std::vector<std::string_view>& words, const Fallback& fallback);
+
+    private:
+        std::vector<double> routeCost;
+        std::vector<std::uint32_t> routeNext;
+        std::vector<TrieDictionary::PrefixMatch> matches;
+
+        void segment_han(const TrieDictionary& dictionary, std::string_view run,
+            std::vector<std::string_view>& words, const Fallback& fallback);
+    };
+}
@@ -0,0 +1,61 @@
+#include "WeightedSimHash.h"
+#include "PlagCheck.h"
+#include "Tokenizer.h"
+#include "Stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace PlagCheck {
+
+    std::bitset<64> compute_weighted_simhash(const std::vector<std::string_view>& words, const CountMinSketch& df) {
+        ScopedTimer timer(Phase::Hash);
+        //排序后相同哈希相邻，游程长度即为词频，无需建立字符串字典
+        std::vector<std::uint64_t> hashes;
+        hashes.reserve(words.size());
+        for (const auto& word : words) {
+            hashes.push_back(string_hash(word));
+        }
+        std::sort(hashes.begin(), hashes.end());
+
+        double documents = static_cast<double>(df.documents());
+        double counters[64] = { 0 };
+        for (std::size_t i = 0; i < hashes.size();) {
+            std::size_t j = i;
+            while (j < hashes.size() && hashes[j] == hashes[i]) {
+                ++j;
+            }
+            std::uint64_t hash = hashes[i];
+            double tf = static_cast<double>(j - i);
+            //Count-Min只会高估，哈希冲突可能使估计超过文档数；截断到N保证idf不小于1，权重不会变号
+            double frequency = std::min(static_cast<double>(df.estimate_hash(hash)), documents);
+            double idf = std::log((1.0 + documents) / (1.0 + frequency)) + 1.0;
+            double weight = tf * idf;
+            for (int bit = 0; bit < 64; ++bit) {
+                counters[bit] += ((hash >> bit) & 1) ? weight : -weight;
+            }
+            i = j;
+        }
+        std::bitset<64> simhash;
+        for (int bit = 0; bit < 64; ++bit) {
+            if (counters[bit] > 0) {
+                simhash.set(bit);
+            }
+        }
+        return simhash;
+    }
+
+    double calcu_weighted_simi(std::string_view original, std::string_view copyed, const CountMinSketch& df) {
+        Tokenizer& tokenizer = Tokenizer::local();
+        std::vector<std::string_view> org_words;
+        std::vector<std::string_view> cop_words;
+        tokenizer.tokenize(original, org_words);
+        tokenizer.tokenize(copyed, cop_words);
+        if (org_words.empty() || cop_words.empty()) {
+            return 0.00;
+        }
+        std::bitset<64> hash1 = compute_weighted_simhash(org_words, df);
+        std::bitset<64> hash2 = compute_weighted_simhash(cop_words, df);
+        return similarity_from_distance(hamming_distance(hash1, hash2));
+    }
+}
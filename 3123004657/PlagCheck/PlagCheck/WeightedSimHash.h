@@ -0,0 +1,28 @@
+#pragma once
+#include "CountMinSketch.h"
+#include <bitset>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 计算TF-IDF加权的SimHash值
+        @details 每个不同的词以 tf × idf 为权重参与累加，其中 idf = ln((1 + N) / (1 + df)) + 1，
+                 N为语料库文档数，df由Count-Min Sketch估计并截断到不超过N，因此idf总不小于1。
+                 “的”“是”“the”等几乎出现在所有文档中的词权重接近最小值，不再主导指纹。
+        @param words 输入的单词视图向量
+        @param df 语料库的文档频率Sketch
+        @return 返回加权的SimHash值
+    */
+    std::bitset<64> compute_weighted_simhash(const std::vector<std::string_view>& words, const CountMinSketch& df);
+
+    /*
+        @brief 使用TF-IDF加权的SimHash计算两个字符串的相似度
+        @param original 原文字符串
+        @param copyed 被查重文章的字符串
+        @param df 语料库的文档频率Sketch
+        @return 返回字符串的相似度
+    */
+    double calcu_weighted_simi(std::string_view original, std::string_view copyed, const CountMinSketch& df);
+}
@@ -0,0 +1,132 @@
+#include "Winnowing.h"
+#include "PlagCheck.h"
+#include "Shingle.h"
+#include "Tokenizer.h"
+#include "Stats.h"
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace PlagCheck {
+
+    std::vector<WinnowFingerprint> winnow(std::string_view content, int k, int window) {
+        if (window < 1) {
+            throw std::invalid_argument("winnowing window must be at least 1.");
+        }
+        if (content.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("document is too large for winnowing.");
+        }
+        ShingleRoller roller(k);
+        std::vector<std::string_view> words;
+        Tokenizer::local().tokenize(content, words);
+
+        //先求出全部k-gram的哈希与字节区间
+        ScopedTimer timer(Phase::Hash);
+        std::vector<WinnowFingerprint> grams;
+        grams.reserve(words.size());
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            std::uint64_t hash;
+            if (!roller.push(string_hash(words[i]), hash)) {
+                continue;
+            }
+            const std::string_view& first = words[i + 1 - static_cast<std::size_t>(k)];
+            WinnowFingerprint gram;
+            gram.hash = hash;
+            gram.begin = static_cast<std::uint32_t>(first.data() - content.data());
+            gram.end = static_cast<std::uint32_t>(words[i].data() + words[i].size() - content.data());
+            grams.push_back(gram);
+        }
+
+        //单调队列维护窗口最小值，队首即当前窗口选中的k-gram
+        std::vector<WinnowFingerprint> selected;
+        std::deque<std::size_t> candidates;
+        std::size_t last = std::numeric_limits<std::size_t>::max();
+        std::size_t w = static_cast<std::size_t>(window);
+        for (std::size_t i = 0; i < grams.size(); ++i) {
+            while (!candidates.empty() && grams[candidates.back()].hash >= grams[i].hash) {
+                candidates.pop_back();
+            }
+            candidates.push_back(i);
+            if (candidates.front() + w <= i) {
+                candidates.pop_front();
+            }
+            //不足一个窗口的短文档也选出其中的最小值
+            if (i + 1 < w && i + 1 < grams.size()) {
+                continue;
+            }
+            if (candidates.front() != last) {
+                last = candidates.front();
+                selected.push_back(grams[last]);
+            }
+        }
+        return selected;
+    }
+
+    std::vector<Passage> merge_passages(std::vector<Passage> hits) {
+        std::sort(hits.begin(), hits.end(), [](const Passage& a, const Passage& b) {
+            return a.queryBegin != b.queryBegin ? a.queryBegin < b.queryBegin : a.docBegin < b.docBegin;
+        });
+        std::vector<Passage> passages;
+        std::vector<Passage> active;
+        for (const auto& hit : hits) {
+            //待查文档中已经不可能再延伸的段落移出活动列表
+            auto done = std::stable_partition(active.begin(), active.end(), [&](const Passage& p) {
+                return p.queryEnd >= hit.queryBegin;
+            });
+            passages.insert(passages.end(), done, active.end());
+            active.erase(done, active.end());
+
+            auto owner = std::find_if(active.begin(), active.end(), [&](const Passage& p) {
+                return hit.docBegin >= p.docBegin && hit.docBegin <= p.docEnd;
+            });
+            if (owner == active.end()) {
+                active.push_back(hit);
+                continue;
+            }
+            owner->queryEnd = std::max(owner->queryEnd, hit.queryEnd);
+            owner->docEnd = std::max(owner->docEnd, hit.docEnd);
+            owner->fingerprints += hit.fingerprints;
+        }
+        passages.insert(passages.end(), active.begin(), active.end());
+        std::sort(passages.begin(), passages.end(), [](const Passage& a, const Passage& b) {
+            return a.queryBegin != b.queryBegin ? a.queryBegin < b.queryBegin : a.docBegin < b.docBegin;
+        });
+        return passages;
+    }
+
+    std::uint64_t covered_bytes(const std::vector<Passage>& passages) {
+        std::uint64_t covered = 0;
+        std::uint32_t reach = 0;
+        for (const auto& passage : passages) {
+            std::uint32_t begin = std::max(passage.queryBegin, reach);
+            if (passage.queryEnd > begin) {
+                covered += passage.queryEnd - begin;
+            }
+            reach = std::max(reach, passage.queryEnd);
+        }
+        return covered;
+    }
+
+    std::vector<Passage> match_passages(std::string_view original, std::string_view copyed, int k, int window) {
+        std::vector<WinnowFingerprint> org = winnow(original, k, window);
+        std::unordered_map<std::uint64_t, std::vector<std::size_t>> positions;
+        positions.reserve(org.size());
+        for (std::size_t i = 0; i < org.size(); ++i) {
+            positions[org[i].hash].push_back(i);
+        }
+
+        std::vector<Passage> hits;
+        for (const auto& fp : winnow(copyed, k, window)) {
+            auto it = positions.find(fp.hash);
+            if (it == positions.end()) {
+                continue;
+            }
+            for (std::size_t i : it->second) {
+                hits.push_back(Passage{ fp.begin, fp.end, org[i].begin, org[i].end, 1 });
+            }
+        }
+        return merge_passages(std::move(hits));
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 一个被选中的winnowing指纹
+        @param hash 单词k-gram的哈希值
+        @param begin k-gram第一个单词在原文中的字节偏移
+        @param end k-gram最后一个单词结尾的字节偏移
+    */
+    struct WinnowFingerprint {
+        std::uint64_t hash;
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+
+    /*
+        @brief 两篇文档中一段相互匹配的文本
+        @param queryBegin 段落在待查文档中的起始字节偏移
+        @param queryEnd 段落在待查文档中的结尾字节偏移
+        @param docBegin 段落在对比文档中的起始字节偏移
+        @param docEnd 段落在对比文档中的结尾字节偏移
+        @param fingerprints 段落包含的公共指纹数
+    */
+    struct Passage {
+        std::uint32_t queryBegin;
+        std::uint32_t queryEnd;
+        std::uint32_t docBegin;
+        std::uint32_t docEnd;
+        std::uint32_t fingerprints;
+    };
+
+    /*
+        @brief 对文档做winnowing，选出带位置信息的k-gram指纹
+        @details 与MOSS相同：对每个单词k-gram计算哈希，在每个由window个连续k-gram组成的窗口中
+                 选出最小的哈希（相同时取最右侧），相邻窗口选中同一个k-gram时只记录一次。
+                 两篇文档中长度不少于 window + k - 1 个单词的公共片段一定会产生至少一个相同指纹，
+                 而短于k个单词的巧合重复不会被选中。
+        @param content 文档内容，不超过4GB
+        @param k k-gram中的单词数，范围[1, 5]
+        @param window winnowing窗口大小
+        @return 返回按位置排序的指纹，单词数少于k的文档没有指纹
+        @throws invalid_argument 如果k或window不合法，或文档超过4GB
+    */
+    std::vector<WinnowFingerprint> winnow(std::string_view content, int k = 5, int window = 4);
+
+    /*
+        @brief 把零散的指纹命中合并为连续的匹配段落
+        @details 待查文档与对比文档中位置都相互重叠的命中属于同一段落。
+                 默认参数下相邻选中的k-gram互相重叠，因此整段抄袭会合并为一个段落。
+        @param hits 指纹命中，每个命中的fingerprints为1
+        @return 返回按待查文档位置排序的段落
+    */
+    std::vector<Passage> merge_passages(std::vector<Passage> hits);
+
+    /*
+        @brief 计算段落在待查文档中覆盖的字节数，重叠部分只计一次
+        @param passages 按queryBegin排序的段落
+    */
+    std::uint64_t covered_bytes(const std::vector<Passage>& passages);
+
+    /*
+        @brief 定位两篇文档之间的全部匹配段落
+        @param original 原文内容
+        @param copyed 待查内容，段落的query偏移指向它，doc偏移指向原文
+        @param k k-gram中的单词数
+        @param window winnowing窗口大小
+        @return 返回按待查文档位置排序的段落
+    */
+    std::vector<Passage> match_passages(std::string_view original, std::string_view copyed, int k = 5, int window = 4);
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PlagCheck {
+    /*
+        @brief 工作窃取线程池
+        @details 每个工作线程拥有自己的双端队列，从队尾取出自己的任务，
+                 空闲时从其他线程的队首窃取任务，使大小不均的任务（如相似度矩阵的对角分块）
+                 能自动在所有核心之间均衡。
+        @method submit 提交任务；在工作线程内提交时放入该线程自己的队列
+        @method wait 阻塞直到所有已提交的任务执行完毕
+        @method size 返回工作线程数
+        @method current_worker 返回当前线程在池中的编号，非池内线程返回-1
+    */
+    class WorkStealingPool {
+    private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+        std::mutex stateMutex;
+        std::condition_variable taskReady;
+        std::condition_variable allDone;
+        std::atomic<std::size_t> queued{ 0 };
+        std::atomic<std::size_t> pending{ 0 };
+        std::atomic<std::size_t> nextWorker{ 0 };
+        bool stopping = false;
+
+        static int& worker_index() {
+            thread_local int index = -1;
+            return index;
+        }
+
+        bool try_pop(std::size_t self, std::function<void()>& task) {
+            //先从自己的队尾取任务，保持局部性
+            {
+                Worker& own = *workers[self];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            //再从其他线程的队首窃取
+            for (std::size_t i = 1; i < workers.size(); ++i) {
+                Worker& victim = *workers[(self + i) % workers.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run(std::size_t self) {
+            worker_index() = static_cast<int>(self);
+            std::function<void()> task;
+            while (true) {
+                if (try_pop(self, task)) {
+                    queued.fetch_sub(1);
+                    task();
+                    task = nullptr;
+                    if (pending.fetch_sub(1) == 1) {
+                        std::lock_guard<std::mutex> lock(stateMutex);
+                        allDone.notify_all();
+                    }
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(stateMutex);
+                taskReady.wait(lock, [this] { return stopping || queued.load() > 0; });
+                if (stopping && queued.load() == 0) {
+                    return;
+                }
+            }
+        }
+
+    public:
+        /*
+            @brief 构造函数，启动工作线程
+            @param threadCount 工作线程数，为0时使用硬件并发数
+        */
+        explicit WorkStealingPool(unsigned threadCount = 0)
+        {
+            if (threadCount == 0) {
+                threadCount = std::max(1u, std::thread::hardware_concurrency());
+            }
+            for (unsigned i = 0; i < threadCount; ++i) {
+                workers.push_back(std::make_unique<Worker>());
+            }
+            for (unsigned i = 0; i < threadCount; ++i) {
+                threads.emplace_back([this, i] { run(i); });
+            }
+        }
+
+        /*
+            @brief 析构函数，执行完剩余任务后停止工作线程
+        */
+        ~WorkStealingPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                stopping = true;
+            }
+            taskReady.notify_all();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        /*
+            @brief 提交任务
+            @param task 要执行的任务，任务内部不应抛出异常
+        */
+        void submit(std::function<void()> task)
+        {
+            int self = worker_index();
+            std::size_t target = self >= 0 && static_cast<std::size_t>(self) < workers.size()
+                ? static_cast<std::size_t>(self)
+                : nextWorker.fetch_add(1) % workers.size();
+            pending.fetch_add(1);
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                queued.fetch_add(1);
+            }
+            {
+                std::lock_guard<std::mutex> lock(workers[target]->mutex);
+                workers[target]->tasks.push_back(std::move(task));
+            }
+            taskReady.notify_one();
+        }
+
+        /*
+            @brief 阻塞直到所有已提交的任务执行完毕，不能在工作线程内调用
+        */
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            allDone.wait(lock, [this] { return pending.load() == 0; });
+        }
+
+        /*
+            @brief 获取工作线程数
+        */
+        std::size_t size() const
+        {
+            return workers.size();
+        }
+
+        /*
+            @brief 获取当前线程在池中的编号
+            @return 返回工作线程编号，非池内线程返回-1
+        */
+        static int current_worker()
+        {
+            return worker_index();
+        }
+    };
+}
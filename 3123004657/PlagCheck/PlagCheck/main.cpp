@@ -2,9 +2,565 @@
 
 #include "FileMana.hpp"
 #include "PlagCheck.h"
+#include "SimHashIndex.h"
+#include "AllPairs.h"
+#include "Clustering.h"
+#include "Tokenizer.h"
+#include "WeightedSimHash.h"
+#include "MinHash.h"
+#include "FingerprintStore.h"
+#include "FingerprintCache.h"
+#include "StreamingSimHash.h"
+#include "PassageIndex.h"
+#include "TextBoundary.h"
+#include "ParallelSimHash.h"
+#include "Stats.h"
+#include "Daemon.h"
+#include "ShardCoordinator.h"
+#include "CorpusIngest.h"
+#include "Shingle.h"
 #include <iomanip>
+#include <algorithm>
+#include <bit>
+#include <memory>
 
-int main(int argc, char* argv[]) {
+/*
+    @brief 各模式共用的命令行选项
+    @param ngram 以几个单词的n-gram为SimHash特征（--ngram N）
+    @param backend 相似度算法，simhash 或 minhash（--backend NAME）
+    @param cachePath 指纹缓存文件，为空时不使用缓存（--cache FILE）
+    @param streaming 是否分块流式读取输入文件（--stream）
+    @param statsPath 性能统计报告文件，为空时不统计（--stats FILE）
+    @param tokenizer 分词引擎，fast、icu 或 dict（--tokenizer NAME）
+    @param dictPath dict分词引擎使用的词典文件（--dict FILE）
+    @param bits SimHash指纹位数，64、128或256（--bits N），目前只用于两文件比较，其余模式的索引与文件格式固定为64位
+*/
+struct CliOptions {
+    int ngram = 1;
+    std::string backend = "simhash";
+    std::string cachePath;
+    bool streaming = false;
+    std::string statsPath;
+    std::string tokenizer = "fast";
+    std::string dictPath;
+    int bits = 64;
+};
+
+static CliOptions cliOptions;
+
+//单个输入文件达到该大小时，单文件查重切片并行分词
+static const std::size_t parallelThreshold = 8 * 1024 * 1024;
+
+/*
+    @brief 从命令行参数中取出全局选项，剩余参数前移
+    @param argc 参数个数，返回时更新为剩余参数个数
+    @param argv 参数数组，返回时只包含剩余参数
+    @throws invalid_argument 如果选项缺少取值或取值无效
+*/
+static void extract_options(int& argc, char* argv[]) {
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ngram") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("--ngram requires a value.");
+            }
+            cliOptions.ngram = std::stoi(argv[++i]);
+            if (cliOptions.ngram < 1 || cliOptions.ngram > PlagCheck::ShingleRoller::maxSize) {
+                throw std::invalid_argument("--ngram must be in [1, 5].");
+            }
+        }
+        else if (arg == "--backend") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("--backend requires a value.");
+            }
+            cliOptions.backend = argv[++i];
+            if (cliOptions.backend != "simhash" && cliOptions.backend != "minhash") {
+                throw std::invalid_argument("--backend must be simhash or minhash.");
+            }
+        }
+        else if (arg == "--stream") {
+            cliOptions.streaming = true;
+        }
+        else if (arg == "--cache") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("--cache requires a value.");
+            }
+            cliOptions.cachePath = argv[++i];
+        }
+        else if (arg == "--stats") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("--stats requires a value.");
+            }
+            cliOptions.statsPath = argv[++i];
+        }
+        else if (arg == "--tokenizer") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("--tokenizer requires a value.");
+            }
+            cliOptions.tokenizer = argv[++i];
+            if (cliOptions.tokenizer != "fast" && cliOptions.tokenizer != "icu" && cliOptions.tokenizer != "dict") {
+                throw std::invalid_argument("--tokenizer must be fast, icu or dict.");
+            }
+        }
+        else if (arg == "--dict") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("--dict requires a value.");
+            }
+            cliOptions.dictPath = argv[++i];
+        }
+        else if (arg == "--bits") {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("--bits requires a value.");
+            }
+            cliOptions.bits = std::stoi(argv[++i]);
+            if (cliOptions.bits != 64 && cliOptions.bits != 128 && cliOptions.bits != 256) {
+                throw std::invalid_argument("--bits must be 64, 128 or 256.");
+            }
+        }
+        else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+}
+
+/*
+    @brief 按 --cache 选项打开指纹缓存
+    @return 返回指纹缓存，未指定 --cache 时返回空指针
+*/
+static std::unique_ptr<PlagCheck::FingerprintCache> open_cache() {
+    if (cliOptions.cachePath.empty()) {
+        return nullptr;
+    }
+    return std::make_unique<PlagCheck::FingerprintCache>(cliOptions.cachePath);
+}
+
+using PlagCheck::list_corpus_files;
+
+/*
+    @brief 计算语料库目录中全部文档的指纹，排除无法读取和没有单词的文档
+    @param dir 语料库目录
+    @param pool 执行任务的线程池
+    @param ngram 以几个单词的n-gram为特征
+    @param strict 为true时遇到无法读取的文件终止，为false时跳过
+    @return 返回保留的文档及其指纹
+    @throws runtime_error 如果strict为true且有文件无法读取
+*/
+static PlagCheck::CorpusFingerprints fingerprint_corpus_dir(const std::string& dir, PlagCheck::WorkStealingPool& pool,
+    int ngram, bool strict = false) {
+    std::unique_ptr<PlagCheck::FingerprintCache> cache = open_cache();
+    PlagCheck::CorpusFingerprints corpus = PlagCheck::fingerprint_corpus(list_corpus_files(dir), pool, ngram, cache.get(), strict);
+    if (cache) {
+        cache->save();
+    }
+    if (corpus.skipped > 0) {
+        std::cout << "skipped empty or unreadable documents: " << corpus.skipped << std::endl;
+    }
+    return corpus;
+}
+
+/*
+    @brief 把相似度格式化为与单文件模式一致的结果行
+    @param similarity 相似度
+    @return 返回形如 "repetition rate = 0.83" 的字符串
+*/
+static std::string format_rate(double similarity) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << similarity;
+    return "repetition rate = " + oss.str();
+}
+
+/*
+    @brief MinHash语料库检索：用LSH分段索引生成候选，输出Jaccard相似度不低于阈值的文档
+    @return 返回进程退出码
+*/
+static int run_minhash_index_mode(int argc, char* argv[]) {
+    double threshold = argc > 5 ? std::stod(argv[5]) : 0.5;
+    PlagCheck::MinHashLSH index;
+    PlagCheck::Tokenizer& tokenizer = PlagCheck::Tokenizer::local();
+    std::vector<std::string_view> words;
+    for (const auto& path : list_corpus_files(argv[2])) {
+        FileManager doc(path, true, false);
+        std::string_view content = doc.read_view();
+        tokenizer.tokenize(content, words);
+        if (!words.empty()) {
+            index.add(path, PlagCheck::compute_minhash(words, 128, cliOptions.ngram));
+        }
+    }
+    std::cout << "indexed documents: " << index.size() << std::endl;
+
+    FileManager queryFile(argv[3], true, false);
+    FileManager resultFile(argv[4], false, true);
+    std::string_view query = queryFile.read_view();
+    tokenizer.tokenize(query, words);
+    for (const auto& match : index.query(PlagCheck::compute_minhash(words, 128, cliOptions.ngram), threshold)) {
+        std::string line = index.doc_id(match.doc) + " " + format_rate(match.similarity) + " \n";
+        resultFile.write_lines(line);
+        std::cout << line;
+    }
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 语料库检索模式：main --index <语料库目录> <待查文件> <结果文件> [最大汉明距离]
+           使用 --backend minhash 时最后一个参数为Jaccard相似度阈值
+    @return 返回进程退出码
+*/
+static int run_index_mode(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cout << "usage: --index <corpus dir> <query file> <result file> [max distance | threshold]" << std::endl;
+        return 1;
+    }
+    if (cliOptions.backend == "minhash") {
+        return run_minhash_index_mode(argc, argv);
+    }
+    int maxDistance = argc > 5 ? std::stoi(argv[5]) : 3;
+    PlagCheck::SimHashIndex index(maxDistance);
+
+    //并行读取语料库并计算指纹，再按路径顺序建立索引；无法读取的文件与逐篇读取时一样终止检索
+    PlagCheck::WorkStealingPool pool;
+    PlagCheck::CorpusFingerprints corpus = fingerprint_corpus_dir(argv[2], pool, cliOptions.ngram, true);
+    for (std::size_t i = 0; i < corpus.paths.size(); ++i) {
+        index.add(corpus.paths[i], corpus.fingerprints[i]);
+    }
+    index.build();
+    std::cout << "indexed documents: " << index.size() << std::endl;
+
+    FileManager queryFile(argv[3], true, false);
+    FileManager resultFile(argv[4], false, true);
+    std::bitset<64> query = PlagCheck::compute_fingerprint(queryFile.read_view(), cliOptions.ngram);
+
+    //输出所有汉明距离不超过阈值的文档
+    for (const auto& match : index.query(query, maxDistance)) {
+        std::string line = index.doc_id(match.doc) + " " +
+            format_rate(PlagCheck::similarity_from_distance(match.distance)) + " \n";
+        resultFile.write_lines(line);
+        std::cout << line;
+    }
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 全量互查模式：main --all-pairs <语料库目录> <结果文件> [相似度阈值] [线程数]
+    @return 返回进程退出码
+*/
+static int run_all_pairs_mode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cout << "usage: --all-pairs <corpus dir> <result file> [threshold] [threads]" << std::endl;
+        return 1;
+    }
+    if (cliOptions.backend != "simhash") {
+        std::cout << "--all-pairs only supports the simhash backend." << std::endl;
+        return 1;
+    }
+    double threshold = argc > 4 ? std::stod(argv[4]) : 0.8;
+    unsigned threads = argc > 5 ? static_cast<unsigned>(std::stoul(argv[5])) : 0;
+    PlagCheck::WorkStealingPool pool(threads);
+
+    //每篇文档只计算一次指纹，再分块填充相似度矩阵
+    PlagCheck::CorpusFingerprints corpus = fingerprint_corpus_dir(argv[2], pool, cliOptions.ngram);
+    std::cout << "fingerprinted documents: " << corpus.paths.size() << std::endl;
+
+    FileManager resultFile(argv[3], false, true);
+    std::string report;
+    for (const auto& pair : PlagCheck::all_pairs(corpus.fingerprints, threshold, pool)) {
+        report += corpus.paths[pair.first] + " " + corpus.paths[pair.second] + " " +
+            format_rate(PlagCheck::similarity_from_distance(pair.distance)) + " \n";
+    }
+    resultFile.write_lines(report);
+    std::cout << report;
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 近似重复聚类模式：main --cluster <语料库目录> <结果文件> [最大汉明距离] [线程数]
+           每行输出一个至少包含两篇文档的家族，按文档数降序
+    @return 返回进程退出码
+*/
+static int run_cluster_mode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cout << "usage: --cluster <corpus dir> <result file> [max distance] [threads]" << std::endl;
+        return 1;
+    }
+    if (cliOptions.backend != "simhash") {
+        std::cout << "--cluster only supports the simhash backend." << std::endl;
+        return 1;
+    }
+    int maxDistance = argc > 4 ? std::stoi(argv[4]) : 3;
+    unsigned threads = argc > 5 ? static_cast<unsigned>(std::stoul(argv[5])) : 0;
+    PlagCheck::WorkStealingPool pool(threads);
+
+    //没有单词的文档指纹全为0，不排除会被全部归入同一个家族
+    PlagCheck::CorpusFingerprints corpus = fingerprint_corpus_dir(argv[2], pool, cliOptions.ngram);
+    std::cout << "fingerprinted documents: " << corpus.paths.size() << std::endl;
+
+    FileManager resultFile(argv[3], false, true);
+    std::string report;
+    std::size_t number = 0;
+    for (const auto& cluster : PlagCheck::cluster_near_duplicates(corpus.fingerprints, maxDistance, pool)) {
+        report += "cluster " + std::to_string(++number) + " size = " + std::to_string(cluster.size()) + ":";
+        for (std::size_t doc : cluster) {
+            report += " " + corpus.paths[doc];
+        }
+        report += " \n";
+    }
+    resultFile.write_lines(report);
+    std::cout << report;
+    std::cout << "clusters: " << number << std::endl;
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 建立文档频率模式：main --build-df <语料库目录> <Sketch文件> [宽度] [深度]
+    @return 返回进程退出码
+*/
+static int run_build_df_mode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cout << "usage: --build-df <corpus dir> <sketch file> [width] [depth]" << std::endl;
+        return 1;
+    }
+    std::uint32_t width = argc > 4 ? static_cast<std::uint32_t>(std::stoul(argv[4])) : 1u << 20;
+    std::uint32_t depth = argc > 5 ? static_cast<std::uint32_t>(std::stoul(argv[5])) : 4;
+    PlagCheck::CountMinSketch sketch(width, depth);
+
+    //逐篇分词，每篇文档中出现过的词计一次
+    std::vector<std::string_view> words;
+    for (const auto& path : list_corpus_files(argv[2])) {
+        FileManager doc(path, true, false);
+        std::string_view content = doc.read_view();
+        PlagCheck::Tokenizer::local().tokenize(content, words);
+        sketch.add_document(words);
+    }
+    sketch.save(argv[3]);
+    std::cout << "documents: " << sketch.documents() << std::endl;
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 建立词典模式：main --build-dict <词表文件> <词典文件>
+           词表每行 "词 [词频] [词性]"，与jieba的dict.txt兼容
+    @return 返回进程退出码
+*/
+static int run_build_dict_mode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cout << "usage: --build-dict <word list> <dictionary file>" << std::endl;
+        return 1;
+    }
+    PlagCheck::TrieDictionary dictionary(PlagCheck::TrieDictionary::read_word_list(argv[2]));
+    dictionary.save(argv[3]);
+    std::cout << "words: " << dictionary.size() << ", units: " << dictionary.unit_count() << std::endl;
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief TF-IDF加权查重模式：main --weighted <Sketch文件> <原文文件> <抄袭版文件> <结果文件>
+    @return 返回进程退出码
+*/
+static int run_weighted_mode(int argc, char* argv[]) {
+    if (argc < 6) {
+        std::cout << "usage: --weighted <sketch file> <original file> <copyed file> <result file>" << std::endl;
+        return 1;
+    }
+    PlagCheck::CountMinSketch sketch = PlagCheck::CountMinSketch::load(argv[2]);
+    FileManager orgPlag(argv[3], true, false);
+    FileManager copyPlag(argv[4], true, false);
+    FileManager resultFile(argv[5], false, true);
+    double similarity_rate = PlagCheck::calcu_weighted_simi(orgPlag.read_view(), copyPlag.read_view(), sketch);
+
+    std::string result = format_rate(similarity_rate) + " \n";
+    resultFile.write_lines(result);
+    std::cout << result;
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 建立指纹文件模式：main --build-store <语料库目录> <指纹文件> [线程数]
+    @return 返回进程退出码
+*/
+static int run_build_store_mode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cout << "usage: --build-store <corpus dir> <store file> [threads]" << std::endl;
+        return 1;
+    }
+    unsigned threads = argc > 4 ? static_cast<unsigned>(std::stoul(argv[4])) : 0;
+    PlagCheck::WorkStealingPool pool(threads);
+    PlagCheck::CorpusFingerprints corpus = fingerprint_corpus_dir(argv[2], pool, cliOptions.ngram);
+    PlagCheck::save_fingerprint_store(argv[3], corpus.paths, corpus.fingerprints, cliOptions.ngram,
+        PlagCheck::Tokenizer::local().segmenter_id());
+    std::cout << "stored documents: " << corpus.paths.size() << std::endl;
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 指纹文件检索模式：main --query-store <指纹文件> <待查文件> <结果文件> [最大汉明距离]
+    @return 返回进程退出码
+*/
+static int run_query_store_mode(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cout << "usage: --query-store <store file> <query file> <result file> [max distance]" << std::endl;
+        return 1;
+    }
+    int maxDistance = argc > 5 ? std::stoi(argv[5]) : 3;
+    //查询指纹必须与指纹文件使用相同的分词配置与n-gram设置
+    PlagCheck::FingerprintStore store(argv[2]);
+    store.check_segmenter(PlagCheck::Tokenizer::local().segmenter_id());
+    FileManager queryFile(argv[3], true, false);
+    FileManager resultFile(argv[4], false, true);
+    std::uint64_t query = PlagCheck::compute_fingerprint(queryFile.read_view(), store.ngram()).to_ullong();
+
+    //直接扫描映射的连续指纹数组
+    PlagCheck::ScopedTimer timer(PlagCheck::Phase::Compare);
+    const std::uint64_t* fingerprints = store.fingerprints();
+    for (std::size_t doc = 0; doc < store.size(); ++doc) {
+        int distance = std::popcount(query ^ fingerprints[doc]);
+        if (distance <= maxDistance) {
+            std::string line = std::string(store.doc_id(doc)) + " " +
+                format_rate(PlagCheck::similarity_from_distance(distance)) + " \n";
+            resultFile.write_lines(line);
+            std::cout << line;
+        }
+    }
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 最相似文档检索模式：main --top-k <语料库目录 | 指纹文件> <待查文件> <结果文件> <k> [最大汉明距离]
+           按相似度从高到低输出最相似的k篇文档，最大汉明距离为置换表能直接回答的距离，默认3
+    @return 返回进程退出码
+*/
+static int run_top_k_mode(int argc, char* argv[]) {
+    if (argc < 6) {
+        std::cout << "usage: --top-k <corpus dir | store file> <query file> <result file> <k> [max distance]" << std::endl;
+        return 1;
+    }
+    std::size_t k = std::stoul(argv[5]);
+    int maxDistance = argc > 6 ? std::stoi(argv[6]) : 3;
+    PlagCheck::SimHashIndex index(maxDistance);
+    int ngram = cliOptions.ngram;
+    if (std::filesystem::is_directory(argv[2])) {
+        PlagCheck::WorkStealingPool pool;
+        PlagCheck::CorpusFingerprints corpus = fingerprint_corpus_dir(argv[2], pool, ngram, true);
+        for (std::size_t i = 0; i < corpus.paths.size(); ++i) {
+            index.add(corpus.paths[i], corpus.fingerprints[i]);
+        }
+    }
+    else {
+        //查询指纹必须与指纹文件使用相同的分词配置与n-gram设置
+        PlagCheck::FingerprintStore store(argv[2]);
+        store.check_segmenter(PlagCheck::Tokenizer::local().segmenter_id());
+        ngram = store.ngram();
+        for (std::size_t doc = 0; doc < store.size(); ++doc) {
+            index.add(std::string(store.doc_id(doc)), store.fingerprint(doc));
+        }
+    }
+    index.build();
+    std::cout << "indexed documents: " << index.size() << std::endl;
+
+    FileManager queryFile(argv[3], true, false);
+    FileManager resultFile(argv[4], false, true);
+    std::bitset<64> query = PlagCheck::compute_fingerprint(queryFile.read_view(), ngram);
+
+    std::string report;
+    for (const auto& match : index.top_k(query, k)) {
+        report += index.doc_id(match.doc) + " " +
+            format_rate(PlagCheck::similarity_from_distance(match.distance)) + " \n";
+    }
+    resultFile.write_lines(report);
+    std::cout << report;
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 截取段落开头的一小段文字用于报告，不截断UTF-8字符，换行替换为空格
+    @param content 文档内容
+    @param begin 段落起始偏移
+    @param end 段落结束偏移
+    @return 返回不超过60字节的摘录
+*/
+static std::string excerpt(std::string_view content, std::uint32_t begin, std::uint32_t end) {
+    std::string_view span = content.substr(begin, end - begin);
+    std::string text(span.substr(0, PlagCheck::utf8_complete_length(span.substr(0, 60))));
+    std::replace(text.begin(), text.end(), '\n', ' ');
+    std::replace(text.begin(), text.end(), '\r', ' ');
+    return span.size() > text.size() ? text + "..." : text;
+}
+
+/*
+    @brief 把一篇文档的匹配段落格式化为报告
+    @param name 对比文档的标识
+    @param passages 匹配段落
+    @param query 待查文档内容
+    @return 返回多行报告文本
+*/
+static std::string format_passages(const std::string& name, const std::vector<PlagCheck::Passage>& passages,
+    std::string_view query) {
+    std::ostringstream oss;
+    double coverage = query.empty() ? 0.0 : static_cast<double>(PlagCheck::covered_bytes(passages)) / query.size();
+    oss << name << " passages = " << passages.size() << " coverage = "
+        << std::fixed << std::setprecision(2) << coverage << " \n";
+    for (const auto& p : passages) {
+        oss << "    query [" << p.queryBegin << ", " << p.queryEnd << ") <-> source ["
+            << p.docBegin << ", " << p.docEnd << ") \"" << excerpt(query, p.queryBegin, p.queryEnd) << "\" \n";
+    }
+    return oss.str();
+}
+
+/*
+    @brief 段落定位模式：main --locate <原文文件 | 语料库目录> <待查文件> <结果文件> [k] [窗口]
+           对比对象为目录时建立winnowing倒排索引，在整个语料库中定位匹配段落
+    @return 返回进程退出码
+*/
+static int run_locate_mode(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cout << "usage: --locate <original file | corpus dir> <query file> <result file> [k] [window]" << std::endl;
+        return 1;
+    }
+    int k = argc > 5 ? std::stoi(argv[5]) : 5;
+    int window = argc > 6 ? std::stoi(argv[6]) : 4;
+    FileManager queryFile(argv[3], true, false);
+    FileManager resultFile(argv[4], false, true);
+    std::string_view query = queryFile.read_view();
+    std::string report;
+
+    if (!std::filesystem::is_directory(argv[2])) {
+        FileManager orgFile(argv[2], true, false);
+        report = format_passages(argv[2], PlagCheck::match_passages(orgFile.read_view(), query, k, window), query);
+    }
+    else {
+        PlagCheck::PassageIndex index(k, window);
+        for (const auto& path : list_corpus_files(argv[2])) {
+            FileManager doc(path, true, false);
+            index.add(path, doc.read_view());
+        }
+        index.build();
+        std::cout << "indexed documents: " << index.size() << " fingerprints: " << index.fingerprint_count()
+            << " posting bytes: " << index.posting_bytes() << std::endl;
+        for (const auto& match : index.locate(query)) {
+            report += format_passages(index.doc_id(match.doc), match.passages, query);
+        }
+    }
+    resultFile.write_lines(report);
+    std::cout << report;
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 单文件查重模式：main <原文文件> <抄袭版文件> <结果文件>
+    @return 返回进程退出码
+*/
+static int run_compare_mode(int argc, char* argv[]) {
     std::vector<std::string> filePaths;
     if (argc < 4){
         std::cout << "three file paths are required as arguments." << std::endl;
@@ -20,19 +576,63 @@ int main(int argc, char* argv[]) {
     //filePaths.emplace_back("C:/cache/study/xt/orig_0.8_del.txt");
     //filePaths.emplace_back("C:/cache/study/xt/answer.txt");
 
+    if (cliOptions.bits != 64 && (cliOptions.streaming || cliOptions.backend != "simhash" || !cliOptions.cachePath.empty())) {
+        std::cout << "--bits cannot be combined with --stream, --cache or --backend minhash." << std::endl;
+        return 1;
+    }
+
 	std::cout << "Original file path: " << filePaths[0] << std::endl;
 	std::cout << "Copyed file path: " << filePaths[1] << std::endl;
 
+    //流式模式：分块读取并直接累加SimHash，内存占用与文件大小无关
+    if (cliOptions.streaming && cliOptions.backend == "simhash") {
+        std::uint64_t orgWords = 0;
+        std::uint64_t copyWords = 0;
+        std::bitset<64> orgHash = PlagCheck::fingerprint_file_streaming(filePaths[0], cliOptions.ngram, 256 * 1024, &orgWords);
+        std::bitset<64> copyHash = PlagCheck::fingerprint_file_streaming(filePaths[1], cliOptions.ngram, 256 * 1024, &copyWords);
+        double rate = orgWords == 0 || copyWords == 0
+            ? 0.00
+            : PlagCheck::similarity_from_distance(PlagCheck::hamming_distance(orgHash, copyHash));
+        FileManager streamResult(filePaths[2], false, true);
+        std::string line = format_rate(rate) + " \n";
+        streamResult.write_lines(line);
+        std::cout << line;
+        std::cout << "finished" << std::endl;
+        return 0;
+    }
+
     //使用FileManager类处理文件
     FileManager orgPlag(filePaths[0], true, false);
     FileManager copyPlag(filePaths[1], true, false);
     FileManager resultFile(filePaths[2], false, true);
-    std::string orgContent = orgPlag.read_lines();
-    std::string copyContent = copyPlag.read_lines();
+    std::string_view orgContent = orgPlag.read_view();
+    std::string_view copyContent = copyPlag.read_view();
 
     //简单的相似度检测
     std::cout << "checking start" << std::endl;
-    double similarity_rate = PlagCheck::calcu_simi(orgContent, copyContent);
+    double similarity_rate = 0.00;
+    std::unique_ptr<PlagCheck::FingerprintCache> cache = open_cache();
+    if (cliOptions.backend == "minhash") {
+        similarity_rate = PlagCheck::calcu_minhash_simi(orgContent, copyContent, cliOptions.ngram);
+    }
+    else if (cache) {
+        similarity_rate = PlagCheck::calcu_simi_cached(orgContent, copyContent, *cache, cliOptions.ngram);
+        cache->save();
+    }
+    else if (cliOptions.bits == 128) {
+        similarity_rate = PlagCheck::calcu_simi<128>(orgContent, copyContent, cliOptions.ngram);
+    }
+    else if (cliOptions.bits == 256) {
+        similarity_rate = PlagCheck::calcu_simi<256>(orgContent, copyContent, cliOptions.ngram);
+    }
+    else if (std::max(orgContent.size(), copyContent.size()) >= parallelThreshold) {
+        //大文件切片后多线程分词，结果与单线程相同
+        PlagCheck::WorkStealingPool pool;
+        similarity_rate = PlagCheck::calcu_simi_parallel(orgContent, copyContent, pool, cliOptions.ngram);
+    }
+    else {
+        similarity_rate = PlagCheck::calcu_simi(orgContent, copyContent, cliOptions.ngram);
+    }
 
     //将结果写入结果文件
     std::ostringstream oss;
@@ -47,4 +647,194 @@ int main(int argc, char* argv[]) {
     copyPlag.close_file();
     resultFile.close_file();
     return 0;
+}
+
+/*
+    @brief 常驻服务模式：main --serve <套接字文件> [语料库目录] [最大汉明距离] [线程数]
+    @return 返回进程退出码
+*/
+static int run_serve_mode(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cout << "usage: --serve <socket path> [corpus dir] [max distance] [threads]" << std::endl;
+        return 1;
+    }
+    PlagCheck::DaemonOptions options;
+    options.ngram = cliOptions.ngram;
+    options.cachePath = cliOptions.cachePath;
+    options.corpusDir = argc > 3 ? argv[3] : "";
+    options.maxDistance = argc > 4 ? std::stoi(argv[4]) : 3;
+    options.threads = argc > 5 ? static_cast<unsigned>(std::stoul(argv[5])) : 0;
+    PlagCheck::Daemon daemon(options);
+    daemon.serve(argv[2]);
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 客户端模式，把请求交给常驻服务处理：
+           main --client <套接字文件> compare <原文文件> <抄袭版文件> <结果文件>
+           main --client <套接字文件> query <待查文件> <结果文件> [最大汉明距离]
+           main --client <套接字文件> ping | shutdown
+    @return 返回进程退出码
+*/
+static int run_client_mode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cout << "usage: --client <socket path> compare <original file> <copyed file> <result file>\n"
+                     "       --client <socket path> query <query file> <result file> [max distance]\n"
+                     "       --client <socket path> ping | shutdown" << std::endl;
+        return 1;
+    }
+    std::string command = argv[3];
+    PlagCheck::LocalSocket socket = PlagCheck::LocalSocket::connect(argv[2]);
+    if (command == "compare" && argc >= 7) {
+        FileManager orgPlag(argv[4], true, false);
+        FileManager copyPlag(argv[5], true, false);
+        FileManager resultFile(argv[6], false, true);
+        std::string rate = PlagCheck::daemon_request(socket, "compare", { orgPlag.read_view(), copyPlag.read_view() });
+        std::string result = "repetition rate = " + rate + " \n";
+        resultFile.write_lines(result);
+        std::cout << result;
+    }
+    else if (command == "query" && argc >= 6) {
+        FileManager queryFile(argv[4], true, false);
+        FileManager resultFile(argv[5], false, true);
+        std::string request = argc > 6 ? "query " + std::string(argv[6]) : "query";
+        std::string report = PlagCheck::daemon_request(socket, request, { queryFile.read_view() });
+        resultFile.write_lines(report);
+        std::cout << report;
+    }
+    else if (command == "ping" || command == "shutdown") {
+        std::cout << PlagCheck::daemon_request(socket, command, {}) << std::endl;
+    }
+    else {
+        std::cout << "unknown client command: " << command << std::endl;
+        return 1;
+    }
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 分片工作进程模式：main --shard-worker <套接字文件> <指纹文件> [分片编号] [分片总数] [线程数]
+           只加载指纹文件中属于本分片的文档，作为常驻服务回答协调器的topk请求
+    @return 返回进程退出码
+*/
+static int run_shard_worker_mode(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cout << "usage: --shard-worker <socket path> <store file> [shard index] [shard count] [threads]" << std::endl;
+        return 1;
+    }
+    PlagCheck::DaemonOptions options;
+    options.cachePath = cliOptions.cachePath;
+    options.storePath = argv[3];
+    options.shardIndex = argc > 4 ? std::stoul(argv[4]) : 0;
+    options.shardCount = argc > 5 ? std::stoul(argv[5]) : 1;
+    options.threads = argc > 6 ? static_cast<unsigned>(std::stoul(argv[6])) : 0;
+    PlagCheck::Daemon daemon(options);
+    daemon.serve(argv[2]);
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 分片检索模式（协调器）：main --shard-query <待查文件> <结果文件> <k> <工作进程套接字>...
+           向全部分片查询最接近的k篇文档并合并
+    @return 返回进程退出码
+*/
+static int run_shard_query_mode(int argc, char* argv[]) {
+    if (argc < 6) {
+        std::cout << "usage: --shard-query <query file> <result file> <k> <worker socket>..." << std::endl;
+        return 1;
+    }
+    std::size_t k = std::stoul(argv[4]);
+    PlagCheck::ShardCoordinator coordinator(std::vector<std::string>(argv + 5, argv + argc));
+    FileManager queryFile(argv[2], true, false);
+    FileManager resultFile(argv[3], false, true);
+    std::bitset<64> query = PlagCheck::compute_fingerprint(queryFile.read_view(), cliOptions.ngram);
+
+    std::string report;
+    for (const auto& match : coordinator.top_k(query, k, cliOptions.ngram, PlagCheck::Tokenizer::local().segmenter_id())) {
+        report += match.docId + " " + format_rate(PlagCheck::similarity_from_distance(match.distance)) + " \n";
+    }
+    resultFile.write_lines(report);
+    std::cout << report;
+    std::cout << "finished" << std::endl;
+    return 0;
+}
+
+/*
+    @brief 按第一个参数选择运行模式
+    @return 返回进程退出码
+*/
+static int dispatch_mode(int argc, char* argv[]) {
+    if (cliOptions.bits != 64 && argc > 1 && std::string(argv[1]).rfind("--", 0) == 0) {
+        std::cout << "--bits only applies to comparing two files." << std::endl;
+        return 1;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--index") {
+        return run_index_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--all-pairs") {
+        return run_all_pairs_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--cluster") {
+        return run_cluster_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--build-df") {
+        return run_build_df_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--build-dict") {
+        return run_build_dict_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--weighted") {
+        return run_weighted_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--build-store") {
+        return run_build_store_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--query-store") {
+        return run_query_store_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--top-k") {
+        return run_top_k_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--locate") {
+        return run_locate_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--serve") {
+        return run_serve_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--client") {
+        return run_client_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--shard-worker") {
+        return run_shard_worker_mode(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--shard-query") {
+        return run_shard_query_mode(argc, argv);
+    }
+    return run_compare_mode(argc, argv);
+}
+
+int main(int argc, char* argv[]) {
+    extract_options(argc, argv);
+    if (cliOptions.tokenizer == "dict") {
+        if (cliOptions.dictPath.empty()) {
+            throw std::invalid_argument("--tokenizer dict requires --dict FILE.");
+        }
+        PlagCheck::Tokenizer::set_dictionary(std::make_shared<PlagCheck::TrieDictionary>(cliOptions.dictPath));
+        PlagCheck::Tokenizer::set_engine(PlagCheck::TokenizerEngine::Dictionary);
+    }
+    else {
+        PlagCheck::Tokenizer::set_engine(cliOptions.tokenizer == "icu"
+            ? PlagCheck::TokenizerEngine::Icu : PlagCheck::TokenizerEngine::AsciiFast);
+    }
+    if (!cliOptions.statsPath.empty()) {
+        PlagCheck::Stats::enable();
+    }
+    int code = dispatch_mode(argc, argv);
+    if (!cliOptions.statsPath.empty()) {
+        PlagCheck::Stats::write(cliOptions.statsPath);
+    }
+    return code;
 }
\ No newline at end of file
@@ -0,0 +1,430 @@
+#include "PlagCheck.h"
+#include "Tokenizer.h"
+#include "SimHashKernel.h"
+#include "SimHashIndex.h"
+#include "AllPairs.h"
+#include "Clustering.h"
+#include "MinHash.h"
+#include "Winnowing.h"
+#include "ParallelSimHash.h"
+#include "IncrementalSimHash.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+    @brief 基准测试的命令行选项
+    @param minSize 最小语料大小（字节）
+    @param maxSize 最大语料大小（字节），语料从minSize起每次乘以32
+    @param minTime 每项测试至少运行的秒数
+    @param outPath 结果文件，JSON Lines格式
+    @param filter 只运行名称包含该字符串的测试
+    @param dictPath dict分词引擎使用的词典文件，为空时用合成语料的中文词表构建
+*/
+struct BenchOptions {
+    std::size_t minSize = 1024;
+    std::size_t maxSize = 32u * 1024 * 1024;
+    double minTime = 0.5;
+    std::string outPath = "bench_results.jsonl";
+    std::string filter;
+    std::string dictPath;
+};
+
+//split_into_words 为每个单词分配std::string，超过该大小的语料跳过此项以免耗尽内存
+static const std::size_t maxOwnedWordsSize = 64u * 1024 * 1024;
+
+/*
+    @brief 解析带K/M/G后缀的字节数
+    @param text 形如 "64M" 的字符串
+    @return 返回字节数
+*/
+static std::size_t parse_size(const std::string& text) {
+    std::size_t pos = 0;
+    double value = std::stod(text, &pos);
+    std::string suffix = text.substr(pos);
+    if (suffix == "K" || suffix == "k") {
+        value *= 1024;
+    }
+    else if (suffix == "M" || suffix == "m") {
+        value *= 1024.0 * 1024;
+    }
+    else if (suffix == "G" || suffix == "g") {
+        value *= 1024.0 * 1024 * 1024;
+    }
+    else if (!suffix.empty()) {
+        throw std::invalid_argument("unknown size suffix: " + suffix);
+    }
+    return static_cast<std::size_t>(value);
+}
+
+/*
+    @brief 合成语料生成器
+    @details 以固定种子从常用词表中随机取词，中文句子以，。结尾、英文句子以逗号句号结尾，
+             每若干句换行成段，mixed在两种语言之间逐句切换并夹杂数字。
+             mutation大于0时以该概率把单词替换为另一个随机词，用于生成“抄袭版”；
+             两份语料使用相同的随机序列，因此其余部分逐字相同。
+*/
+class CorpusGenerator {
+public:
+    /*
+        @brief 中文常用词表，生成中文语料与词典基准的词典共用
+        @return 返回词表
+    */
+    static const std::vector<std::string>& chinese_words() {
+        static const std::vector<std::string> zhWords = {
+            "我们", "研究", "数据", "方法", "系统", "分析", "结果", "问题", "模型", "算法",
+            "计算机", "科学", "技术", "发展", "学生", "老师", "学习", "大学", "今天", "天气",
+            "经济", "社会", "文化", "历史", "中国", "世界", "时间", "工作", "生活", "重要",
+            "实验", "理论", "网络", "信息", "设计", "实现", "性能", "测试", "相似", "文本",
+            "的", "了", "是", "在", "和", "有", "就", "不", "也", "都"
+        };
+        return zhWords;
+    }
+
+    /*
+        @brief 生成指定语言与大小的语料
+        @param language zh、en 或 mixed
+        @param size 目标字节数，结果在不截断UTF-8字符的前提下不超过该值
+        @param mutation 单词被替换的概率
+        @return 返回语料文本
+    */
+    static std::string generate(const std::string& language, std::size_t size, double mutation = 0.0) {
+        const std::vector<std::string>& zhWords = chinese_words();
+        static const std::vector<std::string> enWords = {
+            "the", "of", "and", "to", "in", "is", "that", "for", "it", "as",
+            "was", "with", "be", "by", "on", "not", "this", "are", "from", "or",
+            "data", "system", "method", "result", "analysis", "model", "algorithm", "student", "research", "network",
+            "performance", "similarity", "document", "fingerprint", "experiment", "theory", "design", "history", "world", "time",
+            "computer", "science", "language", "process", "information", "software", "memory", "thread", "index", "query"
+        };
+        std::mt19937_64 rng(20240901);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        std::string text;
+        text.reserve(size + 64);
+        bool chinese = language != "en";
+        int sentence = 0;
+        while (text.size() < size) {
+            if (language == "mixed") {
+                chinese = sentence % 2 == 0;
+            }
+            const std::vector<std::string>& words = chinese ? zhWords : enWords;
+            int length = 6 + static_cast<int>(rng() % 15);
+            for (int w = 0; w < length; ++w) {
+                std::size_t pick = rng() % words.size();
+                std::size_t other = rng() % words.size();
+                if (coin(rng) < mutation) {
+                    pick = other;
+                }
+                if (!chinese && w > 0) {
+                    text += ' ';
+                }
+                text += words[pick];
+                if (language == "mixed" && rng() % 16 == 0) {
+                    text += chinese ? std::to_string(rng() % 2025) : " " + std::to_string(rng() % 2025);
+                }
+            }
+            bool end = rng() % 3 == 0;
+            text += chinese ? (end ? "。" : "，") : (end ? ". " : ", ");
+            if (++sentence % 24 == 0) {
+                text += '\n';
+            }
+        }
+        //按字节截断到目标大小，回退到完整的UTF-8字符
+        std::size_t cut = size;
+        while (cut > 0 && cut < text.size() && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) {
+            --cut;
+        }
+        text.resize(std::min(cut, text.size()));
+        return text;
+    }
+};
+
+/*
+    @brief 一项测试的结果
+    @param name 测试名称
+    @param corpus 语料语言
+    @param bytes 每次迭代处理的字节数
+    @param items 每次迭代处理的条目数（单词、哈希、文档对等）
+    @param itemName 条目的含义
+    @param iterations 迭代次数
+    @param seconds 总耗时
+*/
+struct BenchResult {
+    std::string name;
+    std::string corpus;
+    std::uint64_t bytes = 0;
+    std::uint64_t items = 0;
+    std::string itemName;
+    std::uint64_t iterations = 0;
+    double seconds = 0.0;
+};
+
+/*
+    @brief 基准测试运行器，负责计时与输出JSON Lines
+*/
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& options)
+        : options(options), out(options.outPath, std::ios::app)
+    {
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open result file: " + options.outPath);
+        }
+        std::time_t now = std::time(nullptr);
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        timestamp = stamp;
+    }
+
+    /*
+        @brief 运行一项测试：先预热一次，再反复执行直到累计时间达到minTime
+        @param result 测试的名称、语料与每次迭代的工作量
+        @param body 被测代码
+    */
+    void run(BenchResult result, const std::function<void()>& body)
+    {
+        if (!options.filter.empty() && result.name.find(options.filter) == std::string::npos) {
+            return;
+        }
+        body();
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        do {
+            body();
+            ++result.iterations;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < options.minTime);
+        result.seconds = elapsed;
+        write(result);
+    }
+
+private:
+    const BenchOptions& options;
+    std::ofstream out;
+    std::string timestamp;
+
+    void write(const BenchResult& r)
+    {
+        double perIteration = r.seconds / static_cast<double>(r.iterations);
+        std::ostringstream line;
+        line << "{\"timestamp\":\"" << timestamp << "\""
+             << ",\"kernel\":\"" << PlagCheck::simhash_kernel_name() << "\""
+             << ",\"benchmark\":\"" << r.name << "\""
+             << ",\"corpus\":\"" << r.corpus << "\""
+             << ",\"bytes\":" << r.bytes
+             << ",\"items\":" << r.items
+             << ",\"item\":\"" << r.itemName << "\""
+             << ",\"iterations\":" << r.iterations
+             << ",\"seconds_per_iteration\":" << perIteration
+             << ",\"mb_per_second\":" << (r.bytes / perIteration / (1024.0 * 1024.0))
+             << ",\"items_per_second\":" << (r.items / perIteration)
+             << "}";
+        out << line.str() << "\n";
+        out.flush();
+        std::cerr << line.str() << std::endl;
+    }
+};
+
+/*
+    @brief 单篇文档各阶段与端到端的吞吐量测试
+*/
+static void bench_document(BenchRunner& runner, PlagCheck::WorkStealingPool& pool, const std::string& language, std::size_t size) {
+    std::string content = CorpusGenerator::generate(language, size);
+    std::string copyed = CorpusGenerator::generate(language, size, 0.1);
+    std::vector<std::string_view> words;
+    PlagCheck::Tokenizer::local().tokenize(content, words);
+    std::uint64_t bytes = content.size();
+    std::uint64_t wordCount = words.size();
+    std::string corpus = language + "/" + std::to_string(size);
+
+    if (size <= maxOwnedWordsSize) {
+        runner.run({ "split_into_words", corpus, bytes, wordCount, "words" }, [&] {
+            std::vector<std::string> owned = PlagCheck::split_into_words(content);
+        });
+    }
+    runner.run({ "tokenize", corpus, bytes, wordCount, "words" }, [&] {
+        PlagCheck::Tokenizer::local().tokenize(content, words);
+    });
+    //与ICU、词典引擎比较分词吞吐量，之后恢复默认引擎
+    PlagCheck::Tokenizer::set_engine(PlagCheck::TokenizerEngine::Icu);
+    runner.run({ "tokenize_icu", corpus, bytes, wordCount, "words" }, [&] {
+        PlagCheck::Tokenizer::local().tokenize(content, words);
+    });
+    PlagCheck::Tokenizer::set_engine(PlagCheck::TokenizerEngine::Dictionary);
+    PlagCheck::Tokenizer::local().tokenize(content, words);
+    runner.run({ "tokenize_dict", corpus, bytes, words.size(), "words" }, [&] {
+        PlagCheck::Tokenizer::local().tokenize(content, words);
+    });
+    PlagCheck::Tokenizer::set_engine(PlagCheck::TokenizerEngine::AsciiFast);
+    PlagCheck::Tokenizer::local().tokenize(content, words);
+    volatile std::uint64_t sink = 0;
+    runner.run({ "string_hash", corpus, bytes, wordCount, "words" }, [&] {
+        std::uint64_t acc = 0;
+        for (const auto& word : words) {
+            acc ^= PlagCheck::string_hash(word);
+        }
+        sink = acc;
+    });
+    runner.run({ "compute_simhash", corpus, bytes, wordCount, "words" }, [&] {
+        sink = PlagCheck::compute_simhash(words).to_ullong();
+    });
+    runner.run({ "compute_simhash_ngram3", corpus, bytes, wordCount, "words" }, [&] {
+        sink = PlagCheck::compute_simhash(words, 3).to_ullong();
+    });
+    runner.run({ "compute_simhash_128", corpus, bytes, wordCount, "words" }, [&] {
+        sink = PlagCheck::compute_simhash<128>(words, 1).count();
+    });
+    runner.run({ "compute_simhash_256", corpus, bytes, wordCount, "words" }, [&] {
+        sink = PlagCheck::compute_simhash<256>(words, 1).count();
+    });
+    runner.run({ "calcu_simi", corpus, bytes + copyed.size(), 2, "documents" }, [&] {
+        volatile double similarity = PlagCheck::calcu_simi(content, copyed);
+        (void)similarity;
+    });
+    runner.run({ "compute_fingerprint_parallel", corpus, bytes, wordCount, "words" }, [&] {
+        sink = PlagCheck::compute_fingerprint_parallel(content, 1, pool, 1024 * 1024).to_ullong();
+    });
+    //在文档中间插入再删除一个单词，与compute_simhash重新计算整篇对比
+    PlagCheck::IncrementalSimHash incremental(content);
+    std::size_t editOffset = content.size() / 2;
+    while (editOffset > 0 && (static_cast<unsigned char>(content[editOffset]) & 0xC0) == 0x80) {
+        --editOffset;
+    }
+    const std::string insertion = " revised ";
+    runner.run({ "incremental_replace", corpus, 2 * insertion.size(), 2, "edits" }, [&] {
+        incremental.replace(editOffset, 0, insertion);
+        incremental.replace(editOffset, insertion.size(), "");
+        sink = incremental.fingerprint().to_ullong();
+    });
+    runner.run({ "compute_minhash", corpus, bytes, wordCount, "words" }, [&] {
+        sink = PlagCheck::compute_minhash(words).front();
+    });
+    runner.run({ "winnow", corpus, bytes, wordCount, "words" }, [&] {
+        sink = PlagCheck::winnow(content).size();
+    });
+    (void)sink;
+}
+
+/*
+    @brief 与语料大小无关的批量测试：汉明距离、全量互查、近邻索引查询与近似重复聚类
+*/
+static void bench_batch(BenchRunner& runner, PlagCheck::WorkStealingPool& pool) {
+    std::mt19937_64 rng(7);
+    std::vector<std::bitset<64>> fingerprints(20000);
+    for (auto& fp : fingerprints) {
+        fp = std::bitset<64>(rng());
+    }
+
+    volatile int sink = 0;
+    runner.run({ "hamming_distance", "random", 0, fingerprints.size() - 1, "pairs" }, [&] {
+        int acc = 0;
+        for (std::size_t i = 1; i < fingerprints.size(); ++i) {
+            acc += PlagCheck::hamming_distance(fingerprints[i - 1], fingerprints[i]);
+        }
+        sink = acc;
+    });
+
+    std::uint64_t pairs = static_cast<std::uint64_t>(fingerprints.size()) * (fingerprints.size() - 1) / 2;
+    runner.run({ "all_pairs", "random/20000", 0, pairs, "pairs" }, [&] {
+        sink = static_cast<int>(PlagCheck::all_pairs(fingerprints, 0.9, pool).size());
+    });
+
+    PlagCheck::SimHashIndex index(3);
+    for (std::size_t i = 0; i < fingerprints.size(); ++i) {
+        index.add(std::to_string(i), fingerprints[i]);
+    }
+    index.build();
+    runner.run({ "simhash_index_query", "random/20000", 0, 1000, "queries" }, [&] {
+        int acc = 0;
+        for (std::size_t q = 0; q < 1000; ++q) {
+            acc += static_cast<int>(index.query(fingerprints[q * 7 % fingerprints.size()] ^ std::bitset<64>(1), 3).size());
+        }
+        sink = acc;
+    });
+
+    //10万篇文档，其中2000个家族各15篇：家族成员由同一指纹翻转至多3位得到
+    std::vector<std::bitset<64>> submissions(100000);
+    for (std::size_t i = 0; i < submissions.size(); ++i) {
+        if (i < 30000 && i % 15 != 0) {
+            submissions[i] = submissions[i - i % 15];
+            for (int flip = static_cast<int>(rng() % 4); flip > 0; --flip) {
+                submissions[i].flip(rng() % 64);
+            }
+        }
+        else {
+            submissions[i] = std::bitset<64>(rng());
+        }
+    }
+    runner.run({ "cluster_near_duplicates", "families/100000", 0, submissions.size(), "docs" }, [&] {
+        sink = static_cast<int>(PlagCheck::cluster_near_duplicates(submissions, 3, pool).size());
+    });
+    (void)sink;
+}
+
+/*
+    @brief 基准测试入口：PlagCheckBench [--min-size N] [--max-size N] [--min-time SEC] [--out FILE] [--filter NAME] [--dict FILE]
+           大小可带K/M/G后缀，例如 --max-size 1G 运行1KB～1GB的全部语料
+*/
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "option " << arg << " requires a value." << std::endl;
+            return 1;
+        }
+        if (arg == "--min-size") {
+            options.minSize = parse_size(argv[++i]);
+        }
+        else if (arg == "--max-size") {
+            options.maxSize = parse_size(argv[++i]);
+        }
+        else if (arg == "--min-time") {
+            options.minTime = std::stod(argv[++i]);
+        }
+        else if (arg == "--out") {
+            options.outPath = argv[++i];
+        }
+        else if (arg == "--filter") {
+            options.filter = argv[++i];
+        }
+        else if (arg == "--dict") {
+            options.dictPath = argv[++i];
+        }
+        else {
+            std::cerr << "unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (options.dictPath.empty()) {
+        //合成语料的词表按词频递减排列
+        std::vector<PlagCheck::DictionaryEntry> entries;
+        const std::vector<std::string>& zhWords = CorpusGenerator::chinese_words();
+        for (std::size_t i = 0; i < zhWords.size(); ++i) {
+            entries.push_back({ zhWords[i], static_cast<double>(zhWords.size() - i) * 100.0 });
+        }
+        PlagCheck::Tokenizer::set_dictionary(std::make_shared<PlagCheck::TrieDictionary>(entries));
+    }
+    else {
+        PlagCheck::Tokenizer::set_dictionary(std::make_shared<PlagCheck::TrieDictionary>(options.dictPath));
+    }
+
+    BenchRunner runner(options);
+    PlagCheck::WorkStealingPool pool;
+    bench_batch(runner, pool);
+    for (const char* language : { "zh", "en", "mixed" }) {
+        for (std::size_t size = std::max<std::size_t>(options.minSize, 1); size <= options.maxSize; size *= 32) {
+            bench_document(runner, pool, language, size);
+        }
+    }
+    std::cerr << "results appended to " << options.outPath << std::endl;
+    return 0;
+}
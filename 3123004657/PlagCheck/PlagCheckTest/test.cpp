@@ -0,0 +1,483 @@
+#include "PlagCheck.h"
+#include "SimHashKernel.h"
+#include "AsciiTokenizer.h"
+#include "FingerprintCache.h"
+#include "IncrementalSimHash.h"
+#include "ParallelSimHash.h"
+#include "PlagCheckContext.h"
+#include "StreamingSimHash.h"
+#include "Tokenizer.h"
+#include "TrieDictionary.h"
+#include <bitset>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+    @brief 失败的检查数
+*/
+static int failures = 0;
+
+/*
+    @brief 检查条件，失败时输出说明并计数
+    @param condition 应当成立的条件
+    @param message 失败时输出的说明
+*/
+static void check(bool condition, const std::string& message) {
+    if (!condition) {
+        ++failures;
+        std::cerr << "FAILED: " << message << std::endl;
+    }
+}
+
+/*
+    @brief 参考实现：与最初的compute_simhash相同，逐位判断哈希值的每一位，为1加一、为0减一
+*/
+static void reference_accumulate(const std::vector<std::uint64_t>& hashes, std::vector<int>& counters) {
+    for (std::uint64_t hash : hashes) {
+        for (int i = 0; i < 64; ++i) {
+            if (hash & (1ULL << i)) {
+                counters[i] += 1;
+            }
+            else {
+                counters[i] -= 1;
+            }
+        }
+    }
+}
+
+/*
+    @brief 用一个内核累加hashes，与参考实现逐个比较64个计数器
+    @details 计数器从非0的初值开始，检查内核是累加而不是覆盖
+*/
+static void check_kernel(const char* name,
+    void (*kernel)(const std::uint64_t*, std::size_t, std::int32_t*),
+    const std::vector<std::uint64_t>& hashes, const std::string& input) {
+    std::vector<int> expected(64);
+    std::vector<std::int32_t> actual(64);
+    for (int i = 0; i < 64; ++i) {
+        expected[i] = i - 32;
+        actual[i] = i - 32;
+    }
+    reference_accumulate(hashes, expected);
+    kernel(hashes.data(), hashes.size(), actual.data());
+    for (int i = 0; i < 64; ++i) {
+        if (actual[i] != expected[i]) {
+            check(false, std::string(name) + " counter " + std::to_string(i) + " on " + input + ": got " +
+                std::to_string(actual[i]) + ", expected " + std::to_string(expected[i]));
+            return;
+        }
+    }
+}
+
+/*
+    @brief 标量与AVX2累加内核和逐位参考实现完全一致
+    @details 除随机哈希外，全1与全0的哈希使每个计数器单调变化，
+             长度取AVX2内核16位块长32767的两侧，覆盖块内饱和与换块时扩展到32位的边界
+*/
+static void test_simhash_kernels() {
+    std::mt19937_64 rng(4);
+    const std::size_t lengths[] = { 0, 1, 7, 64, 1000, 32766, 32767, 32768, 65534, 65535, 65536, 100003 };
+    for (std::size_t length : lengths) {
+        std::vector<std::uint64_t> random(length);
+        for (auto& hash : random) {
+            hash = rng();
+        }
+        std::vector<std::vector<std::uint64_t>> inputs = {
+            random,
+            std::vector<std::uint64_t>(length, ~0ULL),
+            std::vector<std::uint64_t>(length, 0),
+            std::vector<std::uint64_t>(length, 0x5555AAAA0000FFFFULL)
+        };
+        const char* kinds[] = { "random", "all ones", "all zeros", "pattern" };
+        for (std::size_t k = 0; k < inputs.size(); ++k) {
+            std::string input = std::string(kinds[k]) + " x" + std::to_string(length);
+            check_kernel("scalar", PlagCheck::accumulate_simhash_scalar, inputs[k], input);
+            if (PlagCheck::cpu_has_avx2()) {
+                check_kernel("avx2", PlagCheck::accumulate_simhash_avx2, inputs[k], input);
+            }
+            check_kernel("selected", PlagCheck::accumulate_simhash, inputs[k], input);
+        }
+    }
+    if (!PlagCheck::cpu_has_avx2()) {
+        std::cout << "note: CPU has no AVX2, only the scalar kernel was checked" << std::endl;
+    }
+}
+
+/*
+    @brief compute_simhash与对单词哈希逐位累加的参考实现得到相同的SimHash值
+*/
+static void test_compute_simhash() {
+    std::mt19937_64 rng(5);
+    std::vector<std::string> vocabulary;
+    for (int i = 0; i < 500; ++i) {
+        vocabulary.push_back("w" + std::to_string(rng() % 100000));
+    }
+    for (std::size_t length : { std::size_t(1), std::size_t(50), std::size_t(40000), std::size_t(70000) }) {
+        std::vector<std::string> words(length);
+        std::vector<std::uint64_t> hashes(length);
+        for (std::size_t n = 0; n < length; ++n) {
+            words[n] = vocabulary[rng() % vocabulary.size()];
+            hashes[n] = PlagCheck::string_hash(words[n]);
+        }
+        std::vector<int> counters(64);
+        reference_accumulate(hashes, counters);
+        std::bitset<64> expected;
+        for (int i = 0; i < 64; ++i) {
+            if (counters[i] > 0) {
+                expected.set(i);
+            }
+        }
+        check(PlagCheck::compute_simhash(words) == expected,
+            "compute_simhash differs from the per-bit reference on " + std::to_string(length) + " words");
+    }
+}
+
+/*
+    @brief 把分词结果转成（在文本中的位置, 单词）序列，比较时位置与内容都要一致
+*/
+static std::vector<std::pair<std::size_t, std::string>> located(std::string_view text,
+    const std::vector<std::string_view>& words) {
+    std::vector<std::pair<std::size_t, std::string>> result;
+    for (const auto& word : words) {
+        result.emplace_back(static_cast<std::size_t>(word.data() - text.data()), std::string(word));
+    }
+    return result;
+}
+
+/*
+    @brief 检查分词结果与ICU的结果相同，不同时输出第一个不同的单词
+*/
+static void check_tokens(const char* name, std::string_view text, const std::vector<std::string_view>& expected,
+    const std::vector<std::string_view>& actual) {
+    auto want = located(text, expected);
+    auto got = located(text, actual);
+    if (want == got) {
+        return;
+    }
+    std::size_t n = 0;
+    while (n < want.size() && n < got.size() && want[n] == got[n]) {
+        ++n;
+    }
+    std::string detail = n < want.size() ? "expected \"" + want[n].second + "\" at " + std::to_string(want[n].first) : "expected end";
+    detail += n < got.size() ? ", got \"" + got[n].second + "\" at " + std::to_string(got[n].first) : ", got end";
+    check(false, std::string(name) + " differs from ICU on a " + std::to_string(text.size()) + "-byte text, word " +
+        std::to_string(n) + ": " + detail);
+}
+
+/*
+    @brief 由片段随机拼接文本，长度取64字节分块的两侧
+*/
+static std::string random_text(std::mt19937_64& rng, const std::vector<std::string>& pieces, std::size_t length) {
+    std::string text;
+    while (text.size() < length) {
+        text += pieces[rng() % pieces.size()];
+    }
+    return text;
+}
+
+/*
+    @brief AsciiFast分词与ICU分词结果相同
+    @details 纯ASCII文本直接交给标量与AVX2两个分类内核，覆盖字母、数字、下划线、@、
+             两侧字母或数字时才连接的 . ' , ; 、空白与各自成词的控制字符；
+             中英混排文本经过Tokenizer的AsciiFast引擎，检查ASCII片段与ICU片段的拼接位置
+*/
+static void test_ascii_tokenizer() {
+    std::mt19937_64 rng(17);
+    PlagCheck::Tokenizer icu;
+    icu.use_engine(PlagCheck::TokenizerEngine::Icu);
+    PlagCheck::Tokenizer fast;
+    fast.use_engine(PlagCheck::TokenizerEngine::AsciiFast);
+    std::vector<std::string> ascii = {
+        "a", "Z", "word", "x", "0", "7", "42", "_", "@", ".", "'", ",", ";", " ", "  ", "\t", "\n", "\r\n",
+        "\v", "\f", "\x01", "\x1f", "\x7f", "-", "!", "?", "(", ")", "\"", "/", ":", "#", "3.14", "1,000", "don't", "e.g."
+    };
+    std::vector<std::string> mixed = ascii;
+    for (const char* piece : { "中文", "查重", "。", "，", "！", "é", "Ω", "日本語", "한국어", "\xe3\x80\x80" }) {
+        mixed.push_back(piece);
+    }
+    std::vector<std::string_view> expected;
+    std::vector<std::string_view> actual;
+    for (int round = 0; round < 2000; ++round) {
+        std::size_t length = round < 1000 ? rng() % 300 : 60 + rng() % 5000;
+        std::string text = random_text(rng, ascii, length);
+        icu.tokenize(text, expected);
+        actual.clear();
+        PlagCheck::tokenize_ascii_scalar(text, actual);
+        check_tokens("scalar classifier", text, expected, actual);
+        if (PlagCheck::cpu_has_avx2()) {
+            actual.clear();
+            PlagCheck::tokenize_ascii_avx2(text, actual);
+            check_tokens("avx2 classifier", text, expected, actual);
+        }
+        std::string mixedText = random_text(rng, mixed, length);
+        icu.tokenize(mixedText, expected);
+        fast.tokenize(mixedText, actual);
+        check_tokens("AsciiFast engine", mixedText, expected, actual);
+    }
+}
+
+/*
+    @brief 引擎或词典不同的两个上下文使用同一个缓存文件时，各自得到与不用缓存时相同的指纹
+*/
+static void test_context_cache_isolation() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "plagcheck_test_context";
+    std::filesystem::create_directories(dir);
+    std::string dictPath = (dir / "dict.bin").string();
+    std::string cachePath = (dir / "cache.bin").string();
+    std::filesystem::remove(cachePath);
+    PlagCheck::TrieDictionary({ { "我们", 90 }, { "研究", 100 }, { "计算机", 30 }, { "科学", 20 },
+        { "数据", 80 }, { "分析", 60 }, { "方法", 50 }, { "系统", 40 } }).save(dictPath);
+    const std::string text = "我们研究计算机科学的数据分析方法和系统，我们研究数据。";
+
+    auto fingerprint = [&](PlagCheck::TokenizerEngine engine, const std::string& cache, std::uint64_t& words) {
+        PlagCheck::ContextOptions options;
+        options.engine = engine;
+        options.cachePath = cache;
+        if (engine == PlagCheck::TokenizerEngine::Dictionary) {
+            options.dictionaryPath = dictPath;
+        }
+        PlagCheck::PlagCheckContext context(options);
+        std::bitset<64> result = context.fingerprint(text, &words);
+        context.save_cache();
+        return result;
+    };
+    std::uint64_t icuWords = 0;
+    std::uint64_t dictWords = 0;
+    std::uint64_t words = 0;
+    std::bitset<64> icu = fingerprint(PlagCheck::TokenizerEngine::Icu, "", icuWords);
+    std::bitset<64> dict = fingerprint(PlagCheck::TokenizerEngine::Dictionary, "", dictWords);
+    check(icuWords != dictWords, "the test text should segment differently under ICU and the dictionary");
+    //先由ICU上下文写入缓存，再由词典上下文读取同一个文件，反过来再检查一次
+    check(fingerprint(PlagCheck::TokenizerEngine::Icu, cachePath, words) == icu && words == icuWords,
+        "ICU context with a cache differs from the uncached result");
+    check(fingerprint(PlagCheck::TokenizerEngine::Dictionary, cachePath, words) == dict && words == dictWords,
+        "dictionary context returned a cache entry written by the ICU context");
+    check(fingerprint(PlagCheck::TokenizerEngine::Icu, cachePath, words) == icu && words == icuWords,
+        "ICU context returned a cache entry written by the dictionary context");
+    std::filesystem::remove_all(dir);
+}
+
+/*
+    @brief 有容量的指纹缓存不超过容量，淘汰最近没有命中的记录
+*/
+static void test_cache_eviction() {
+    PlagCheck::FingerprintCache cache("", 3);
+    PlagCheck::SegmenterId segmenter;
+    std::vector<PlagCheck::ContentKey> keys;
+    for (int i = 0; i < 5; ++i) {
+        keys.push_back(PlagCheck::FingerprintCache::key_of("document " + std::to_string(i), 1, segmenter));
+    }
+    PlagCheck::CacheEntry entry = {};
+    for (int i = 0; i < 3; ++i) {
+        entry.words = static_cast<std::uint64_t>(i);
+        cache.store(keys[i], entry);
+    }
+    //命中过的第0条在下一次淘汰中保留，第1条被淘汰
+    check(cache.lookup(keys[0], entry) && entry.words == 0, "cache lost an entry before reaching its capacity");
+    cache.store(keys[3], entry);
+    check(cache.size() == 3, "cache grew past its capacity");
+    check(cache.lookup(keys[0], entry), "cache evicted a recently used entry");
+    check(!cache.lookup(keys[1], entry), "cache kept the least recently used entry");
+    check(cache.lookup(keys[3], entry), "cache dropped the newly stored entry");
+    for (int round = 0; round < 100; ++round) {
+        cache.store(PlagCheck::FingerprintCache::key_of("one-off " + std::to_string(round), 1, segmenter), entry);
+    }
+    check(cache.size() == 3, "cache grew past its capacity under one-off submissions");
+}
+
+/*
+    @brief 中英混排文档的片段，含全角句读、数字中的全角，；、组合字符、ZWJ与各种空白，覆盖各个安全切分点的判断
+*/
+static const std::vector<std::string> documentPieces = {
+    "the ", "word ", "data", "system", " ", "  ", "\n", "\r\n", "\t", ".", ",", "don't ", "3.14", "1,000",
+    "我们", "研究", "数据", "分析", "方法", "的", "。", "，", "；", "！", "？", "1，000", "2；3", "，5", "一，二",
+    "é", "日本語", "\xe3\x80\x80", "\xe2\x80\x83", "\xc2\xa0", "\xcc\x81", "\xe2\x80\x8d", "\xf0\x9f\x98\x80"
+};
+
+/*
+    @brief 把pos向前移到不在多字节UTF-8字符中间的位置
+*/
+static std::size_t char_boundary(const std::string& text, std::size_t pos) {
+    while (pos > 0 && pos < text.size() && (static_cast<unsigned char>(text[pos]) & 0xC0) == 0x80) {
+        --pos;
+    }
+    return pos;
+}
+
+/*
+    @brief 用当前线程的Tokenizer计算单词数
+*/
+static std::uint64_t word_count(std::string_view text) {
+    std::vector<std::string_view> words;
+    PlagCheck::Tokenizer::local().tokenize(text, words);
+    return words.size();
+}
+
+/*
+    @brief IncrementalSimHash在任意编辑序列之后都与对当前文本整篇计算的结果相同
+    @details 对n = 1..5各做随机的replace与assign，每次编辑后比较文本、单词数与SimHash值
+*/
+static void test_incremental_simhash() {
+    std::mt19937_64 rng(24);
+    for (int ngram = 1; ngram <= 5; ++ngram) {
+        std::string expected = random_text(rng, documentPieces, 2000);
+        PlagCheck::IncrementalSimHash incremental(expected, ngram);
+        for (int edit = 0; edit < 3000; ++edit) {
+            std::size_t offset = char_boundary(expected, static_cast<std::size_t>(rng() % (expected.size() + 1)));
+            std::size_t end = char_boundary(expected, std::min(expected.size(), offset + static_cast<std::size_t>(rng() % 48)));
+            std::size_t length = end - offset;
+            std::string replacement = random_text(rng, documentPieces, static_cast<std::size_t>(rng() % 32));
+            expected.replace(offset, length, replacement);
+            //偶尔清空文档，覆盖单词数不足n个时整篇重新计算的路径
+            if (edit % 500 == 499) {
+                expected = random_text(rng, documentPieces, static_cast<std::size_t>(rng() % 8));
+            }
+            if (edit % 5 == 0 || edit % 500 == 499) {
+                incremental.assign(expected);
+            }
+            else {
+                incremental.replace(offset, length, replacement);
+            }
+            std::string where = "n=" + std::to_string(ngram) + " edit " + std::to_string(edit);
+            if (incremental.text() != expected) {
+                check(false, "IncrementalSimHash text differs after " + where);
+                break;
+            }
+            if (incremental.fingerprint() != PlagCheck::compute_fingerprint(expected, ngram) ||
+                incremental.words() != word_count(expected)) {
+                check(false, "IncrementalSimHash differs from compute_fingerprint after " + where);
+                break;
+            }
+        }
+    }
+}
+
+/*
+    @brief StreamingSimHash按任意块大小输入时与整篇计算的结果相同
+    @details 块边界会截断多字节字符、单词与数字中的全角，；
+*/
+static void test_streaming_simhash() {
+    std::mt19937_64 rng(10);
+    const std::size_t chunkSizes[] = { 1, 2, 3, 7, 64, 1000, 65536 };
+    for (std::size_t length : { std::size_t(0), std::size_t(5), std::size_t(3000), std::size_t(200000) }) {
+        std::string text = random_text(rng, documentPieces, length);
+        for (int ngram = 1; ngram <= 5; ++ngram) {
+            std::bitset<64> expected = PlagCheck::compute_fingerprint(text, ngram);
+            std::uint64_t expectedWords = word_count(text);
+            for (std::size_t chunk : chunkSizes) {
+                //块很小而文本很长时太慢，跳过
+                if (chunk < 64 && length > 3000) {
+                    continue;
+                }
+                PlagCheck::StreamingSimHash streaming(ngram);
+                for (std::size_t pos = 0; pos < text.size(); pos += chunk) {
+                    streaming.feed(std::string_view(text).substr(pos, chunk));
+                }
+                streaming.finish();
+                check(streaming.fingerprint() == expected && streaming.words() == expectedWords,
+                    "StreamingSimHash differs from compute_fingerprint on " + std::to_string(length) + " bytes, n=" +
+                    std::to_string(ngram) + ", chunk " + std::to_string(chunk));
+            }
+        }
+    }
+}
+
+/*
+    @brief compute_fingerprint_parallel在任意片段大小下与顺序计算的结果相同
+*/
+static void test_parallel_simhash() {
+    std::mt19937_64 rng(13);
+    PlagCheck::WorkStealingPool pool(4);
+    for (std::size_t length : { std::size_t(0), std::size_t(100), std::size_t(50000), std::size_t(400000) }) {
+        std::string text = random_text(rng, documentPieces, length);
+        for (int ngram = 1; ngram <= 5; ++ngram) {
+            std::bitset<64> expected = PlagCheck::compute_fingerprint(text, ngram);
+            std::uint64_t expectedWords = word_count(text);
+            for (std::size_t pieceSize : { std::size_t(1), std::size_t(100), std::size_t(4096), std::size_t(65536) }) {
+                std::uint64_t words = 0;
+                std::bitset<64> actual = PlagCheck::compute_fingerprint_parallel(text, ngram, pool, pieceSize, &words);
+                check(actual == expected && words == expectedWords,
+                    "compute_fingerprint_parallel differs from compute_fingerprint on " + std::to_string(length) +
+                    " bytes, n=" + std::to_string(ngram) + ", piece " + std::to_string(pieceSize));
+            }
+        }
+    }
+}
+
+/*
+    @brief 词典save之后映射加载，查词与分词结果都与内存中构建的词典相同
+*/
+static void test_dictionary_round_trip() {
+    std::mt19937_64 rng(18);
+    const std::vector<std::string> characters = {
+        "我", "们", "研", "究", "数", "据", "分", "析", "方", "法", "系", "统", "计", "算", "机", "科", "学", "的"
+    };
+    std::vector<PlagCheck::DictionaryEntry> entries;
+    for (int i = 0; i < 300; ++i) {
+        std::string word;
+        for (std::size_t n = 0, length = 1 + rng() % 4; n < length; ++n) {
+            word += characters[rng() % characters.size()];
+        }
+        entries.push_back({ word, static_cast<double>(1 + rng() % 1000) });
+    }
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "plagcheck_test_dictionary";
+    std::filesystem::create_directories(dir);
+    std::string path = (dir / "dict.bin").string();
+    auto built = std::make_shared<PlagCheck::TrieDictionary>(entries);
+    built->save(path);
+    auto mapped = std::make_shared<PlagCheck::TrieDictionary>(path);
+    check(mapped->size() == built->size() && mapped->unit_count() == built->unit_count() &&
+        mapped->unknown_cost() == built->unknown_cost() && mapped->content_hash() == built->content_hash(),
+        "mapped dictionary header or content hash differs from the built dictionary");
+    for (const auto& entry : entries) {
+        float builtCost = 0;
+        float mappedCost = 0;
+        if (!mapped->lookup(entry.word, &mappedCost) || !built->lookup(entry.word, &builtCost) || mappedCost != builtCost) {
+            check(false, "mapped dictionary lookup differs for " + entry.word);
+            break;
+        }
+    }
+    PlagCheck::Tokenizer builtTokenizer;
+    builtTokenizer.use_engine(PlagCheck::TokenizerEngine::Dictionary, built);
+    PlagCheck::Tokenizer mappedTokenizer;
+    mappedTokenizer.use_engine(PlagCheck::TokenizerEngine::Dictionary, mapped);
+    std::vector<std::string> pieces = documentPieces;
+    pieces.insert(pieces.end(), characters.begin(), characters.end());
+    std::vector<std::string_view> expected;
+    std::vector<std::string_view> actual;
+    for (int round = 0; round < 200; ++round) {
+        std::string text = random_text(rng, pieces, static_cast<std::size_t>(rng() % 3000));
+        builtTokenizer.tokenize(text, expected);
+        mappedTokenizer.tokenize(text, actual);
+        check_tokens("mapped dictionary", text, expected, actual);
+    }
+    mapped.reset();
+    std::filesystem::remove_all(dir);
+}
+
+/*
+    @brief 测试入口：依次运行各项检查，有失败时返回1
+*/
+int main() {
+    test_simhash_kernels();
+    test_compute_simhash();
+    test_ascii_tokenizer();
+    test_context_cache_isolation();
+    test_cache_eviction();
+    test_incremental_simhash();
+    test_streaming_simhash();
+    test_parallel_simhash();
+    test_dictionary_round_trip();
+    if (failures > 0) {
+        std::cout << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed (kernel: " << PlagCheck::simhash_kernel_name() << ")" << std::endl;
+    return 0;
+}
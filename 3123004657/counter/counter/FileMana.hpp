@@ -6,6 +6,17 @@
 #include <sstream>
 #include <stdexcept>
 #include <filesystem>
+#include <string_view>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /**
  * @brief 文件管理类
@@ -15,6 +26,9 @@
  * @param isOpen 文件是否打开
  * @param readable 文件是否可读
  * @param writable 文件是否可写
+ * @param mappedData 内存映射的文件内容
+ * @param mappedSize 内存映射的字节数
+ * @param viewBuffer 无法映射时保存文件内容的缓冲区
  */
 class FileManager{
     private:
@@ -23,6 +37,84 @@ class FileManager{
         bool isOpen = false;
         bool readable = false;
         bool writable = false;
+        const char* mappedData = nullptr;
+        std::size_t mappedSize = 0;
+        std::string viewBuffer;
+#ifdef _WIN32
+        HANDLE mappingHandle = nullptr;
+#endif
+
+        /**
+         * @brief 尝试把文件只读映射到内存
+         * @return 映射成功返回true；文件为空、不是普通文件或映射失败返回false
+        */
+        bool map_file()
+        {
+#ifdef _WIN32
+            HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                return false;
+            }
+            LARGE_INTEGER size{};
+            if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+                CloseHandle(file);
+                return false;
+            }
+            mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file);
+            if (mappingHandle == nullptr) {
+                return false;
+            }
+            void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (view == nullptr) {
+                CloseHandle(mappingHandle);
+                mappingHandle = nullptr;
+                return false;
+            }
+            mappedData = static_cast<const char*>(view);
+            mappedSize = static_cast<std::size_t>(size.QuadPart);
+            return true;
+#else
+            int fd = ::open(filePath.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+            struct stat info {};
+            if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+                ::close(fd);
+                return false;
+            }
+            void* view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (view == MAP_FAILED) {
+                return false;
+            }
+            ::madvise(view, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+            mappedData = static_cast<const char*>(view);
+            mappedSize = static_cast<std::size_t>(info.st_size);
+            return true;
+#endif
+        }
+
+        /**
+         * @brief 解除内存映射并清空缓冲区
+        */
+        void release_view()
+        {
+            if (mappedData != nullptr) {
+#ifdef _WIN32
+                UnmapViewOfFile(mappedData);
+                CloseHandle(mappingHandle);
+                mappingHandle = nullptr;
+#else
+                ::munmap(const_cast<char*>(mappedData), mappedSize);
+#endif
+                mappedData = nullptr;
+                mappedSize = 0;
+            }
+            viewBuffer.clear();
+        }
 
     public:
         /**
@@ -65,8 +157,12 @@ class FileManager{
             if (isOpen) {
                 fileStream.close();
             }
+            release_view();
         }
 
+        FileManager(const FileManager&) = delete;
+        FileManager& operator=(const FileManager&) = delete;
+
         /**
          * @brief 检查文件是否打开
          * @return 如果文件已打开返回true，否则返回false
@@ -110,6 +206,29 @@ class FileManager{
             return content;
         }
 
+        /**
+         * @brief 以内存映射方式读取整个文件，不经过iostream复制
+         * @details 普通文件直接映射并提示按顺序预读；管道等无法映射的文件退回到缓冲读取。
+         *          返回的视图在FileManager析构或close_file之前有效
+         * @return 返回文件内容的字符串视图
+         * @throws runtime_error 如果文件未打开或不可读
+        */
+        std::string_view read_view()
+        {
+            if (!is_file_readable()) {
+                throw std::runtime_error("File is not open for reading.");
+            }
+            if (mappedData == nullptr && viewBuffer.empty() && !map_file()) {
+                std::stringstream buffer;
+                buffer << fileStream.rdbuf();
+                viewBuffer = buffer.str();
+            }
+            if (mappedData != nullptr) {
+                return std::string_view(mappedData, mappedSize);
+            }
+            return viewBuffer;
+        }
+
         /**
          * @brief 写入内容到文件
          * @param content 要写入的内容字符串
@@ -135,5 +254,6 @@ class FileManager{
                 fileStream.close();
                 isOpen = false;
             }
+            release_view();
         }
 };
\ No newline at end of file
@@ -96,8 +96,8 @@ int main(int argc, char* argv[]) {
         std::string answerFile = argv[answerFileIndex];
         FileManager exerciseFM(exerciseFile, true, false);
         FileManager answerFM(answerFile, true, false);
-        std::string exerciseContent = exerciseFM.read_lines();
-        std::string answerContent = answerFM.read_lines();
+        std::string exerciseContent(exerciseFM.read_view());
+        std::string answerContent(answerFM.read_view());
 
         //检查答案
         AnswerCheck answerCheck = AnswerCheck();